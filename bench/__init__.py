@@ -0,0 +1 @@
+"""Micro-benchmark suite for PyGreSQL."""
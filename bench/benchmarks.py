@@ -0,0 +1,160 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+"""Micro-benchmarks for the hot paths of PyGreSQL.
+
+Each benchmark pins one workload so that regressions in the C extension
+show up as a shift in a single number: the scalar typecasts for the
+common column types, the construction of tuple, dictionary and named
+results, COPY throughput in both directions, and the array parser at
+several nesting depths.
+
+The suite is based on pyperf and is run directly or through the setup
+script, writing the results as JSON for tracking across releases::
+
+    python setup.py bench --output=bench.json
+    python -m pyperf compare_to old.json bench.json
+
+Most benchmarks need a database to run against, configured in the same
+way as the unit tests (via LOCAL_PyGreSQL.py or the defaults below).
+"""
+
+from __future__ import print_function
+
+import pyperf
+
+import pg  # the module under benchmark
+
+# We need a database to benchmark against.  If LOCAL_PyGreSQL.py exists
+# we will get our information from that.  Otherwise we use the defaults.
+dbname = 'unittest'
+dbhost = None
+dbport = 5432
+
+try:
+    from tests.LOCAL_PyGreSQL import *  # noqa: F401,F403
+except (ImportError, ValueError):
+    try:
+        from LOCAL_PyGreSQL import *  # noqa: F401,F403
+    except ImportError:
+        pass
+
+num_rows = 1000  # number of rows in every benchmark table
+
+# one table per scalar cast benchmark, filled with num_rows
+# typical values of the given type
+cast_tables = [
+    ('bench_cast_int', 'int4', "(i - %d)" % (num_rows // 2,)),
+    ('bench_cast_long', 'int8', "(i * 4294967296)"),
+    ('bench_cast_float', 'float8', "(i * 0.25)"),
+    ('bench_cast_numeric', 'numeric(12,2)', "(i * 0.01)"),
+    ('bench_cast_bool', 'bool', "(i %% 2 = 0)"),
+    ('bench_cast_text', 'text', "('row number ' || i)"),
+    ('bench_cast_bytea', 'bytea', "decode(md5(i::text), 'hex')")]
+
+connection = None
+
+
+def get_connection():
+    """Return the shared benchmark connection, creating it on demand."""
+    global connection
+    if connection is None:
+        connection = pg.connect(dbname, dbhost, dbport)
+        create_tables(connection)
+    return connection
+
+
+def create_tables(c):
+    """Create and fill the benchmark tables."""
+    for table, typ, value in cast_tables:
+        c.query('create temporary table %s (data %s)' % (table, typ))
+        c.query('insert into %s select %s'
+                ' from generate_series(1, %d) i' % (table, value, num_rows))
+    c.query('create temporary table bench_rows'
+            ' (n int4, x float8, d numeric(12,2), t text)')
+    c.query("insert into bench_rows"
+            " select i, i * 0.25, i * 0.01, 'row number ' || i"
+            " from generate_series(1, %d) i" % (num_rows,))
+    c.query('create temporary table bench_copy'
+            ' (n int4, x float8, t text)')
+
+
+def bench_cast(table):
+    """Fetch one column so that only the scalar cast is measured."""
+    get_connection().query('select data from ' + table).getresult()
+
+
+def bench_tuple_result():
+    get_connection().query('select * from bench_rows').getresult()
+
+
+def bench_dict_result():
+    get_connection().query('select * from bench_rows').dictresult()
+
+
+def bench_named_result():
+    get_connection().query('select * from bench_rows').namedresult()
+
+
+class NullSink(object):
+    """A writable file-like object that discards all data."""
+
+    def write(self, data):
+        pass
+
+
+def bench_copy_to():
+    get_connection().copyto('copy bench_rows to stdout', NullSink())
+
+
+copy_rows = [(i, i * 0.25, 'row number %d' % (i,))
+             for i in range(1, num_rows + 1)]
+
+
+def bench_copy_from():
+    # the truncation is part of the workload, but its cost is constant
+    c = get_connection()
+    c.query('truncate bench_copy')
+    c.inserttable('bench_copy', copy_rows)
+
+
+def bench_copy_from_binary():
+    c = get_connection()
+    c.query('truncate bench_copy')
+    c.inserttable_binary('bench_copy', copy_rows)
+
+
+def make_array_text(depth):
+    """Build the text form of a nested array with the given depth."""
+    s = ','.join(str(i) for i in range(10))
+    for _i in range(depth):
+        s = '{%s}' % (','.join([s] * (10 if depth == 1 else 3)),)
+    return s
+
+
+array_texts = [make_array_text(depth) for depth in (1, 2, 3)]
+
+
+def bench_cast_array(text):
+    pg.cast_array(text)
+
+
+def main():
+    runner = pyperf.Runner()
+    runner.metadata['pygresql_version'] = pg.version
+
+    for table, _typ, _value in cast_tables:
+        runner.bench_func(table, bench_cast, table)
+    runner.bench_func('bench_tuple_result', bench_tuple_result)
+    runner.bench_func('bench_dict_result', bench_dict_result)
+    runner.bench_func('bench_named_result', bench_named_result)
+    runner.bench_func('bench_copy_to', bench_copy_to)
+    runner.bench_func('bench_copy_from', bench_copy_from)
+    runner.bench_func('bench_copy_from_binary', bench_copy_from_binary)
+    for depth, text in enumerate(array_texts, 1):
+        runner.bench_func('bench_cast_array_depth%d' % (depth,),
+                          bench_cast_array, text)
+
+
+if __name__ == '__main__':
+    main()
@@ -93,7 +93,6 @@ from math import isnan, isinf
 from collections import namedtuple, OrderedDict
 from operator import itemgetter
 from functools import partial
-from re import compile as regex
 from json import loads as jsondecode, dumps as jsonencode
 from uuid import UUID
 
@@ -207,17 +206,39 @@ except ImportError:  # Python < 3.2
 
 # Auxiliary classes and functions that are independent of a DB connection:
 
-try:  # noinspection PyUnresolvedReferences
-    from inspect import signature
-except ImportError:  # Python < 3.3
-    from inspect import getargspec
+def get_args(func):
+    """Get the arguments of the given function.
 
-    def get_args(func):
+    The inspect module is fairly expensive to import, so it is only
+    imported here when a typecast function is actually inspected,
+    instead of slowing down every import of this module.
+    """
+    try:  # noinspection PyUnresolvedReferences
+        from inspect import signature
+    except ImportError:  # Python < 3.3
+        from inspect import getargspec
         return getargspec(func).args
-else:
+    return list(signature(func).parameters)
+
+
+class _LazyRegex(object):
+    """Regular expression that is only compiled when first used.
+
+    Compiling all regular expressions up front takes a considerable
+    part of the module import time, which matters for short-lived
+    processes, so the compilation is deferred until a pattern is
+    actually used.
+    """
+
+    def __init__(self, pattern):
+        self._pattern = pattern
+
+    def __getattr__(self, name):
+        from re import compile as regex
+        value = getattr(regex(self._pattern), name)
+        setattr(self, name, value)  # cache for subsequent uses
+        return value
 
-    def get_args(func):
-        return list(signature(func).parameters)
 
 try:
     from datetime import timezone
@@ -287,7 +308,7 @@ class Bytea(bytes):
 class Hstore(dict):
     """Wrapper class for marking hstore values."""
 
-    _re_quote = regex('^[Nn][Uu][Ll][Ll]$|[ ,=>]')
+    _re_quote = _LazyRegex('^[Nn][Uu][Ll][Ll]$|[ ,=>]')
 
     @classmethod
     def _quote(cls, s):
@@ -441,9 +462,9 @@ class Adapter:
         'current_date current_time'
         ' current_timestamp localtime localtimestamp'.split())
 
-    _re_array_quote = regex(r'[{},"\\\s]|^[Nn][Uu][Ll][Ll]$')
-    _re_record_quote = regex(r'[(,"\\]')
-    _re_array_escape = _re_record_escape = regex(r'(["\\])')
+    _re_array_quote = _LazyRegex(r'[{},"\\\s]|^[Nn][Uu][Ll][Ll]$')
+    _re_record_quote = _LazyRegex(r'[(,"\\]')
+    _re_array_escape = _re_record_escape = _LazyRegex(r'(["\\])')
 
     def __init__(self, db):
         self.db = weakref.proxy(db)
@@ -477,6 +498,9 @@ class Adapter:
 
     def _adapt_bytea(self, v):
         """Adapt a bytea parameter."""
+        if get_binary_params():
+            # the C module sends the raw bytes in binary form
+            return v
         return self.db.escape_bytea(v)
 
     def _adapt_json(self, v):
@@ -884,7 +908,7 @@ def cast_time(value):
     return datetime.strptime(value, fmt).time()
 
 
-_re_timezone = regex('(.*)([+-].*)')
+_re_timezone = _LazyRegex('(.*)([+-].*)')
 
 
 def cast_timetz(value):
@@ -963,18 +987,18 @@ def cast_timestamptz(value, connection):
         tzinfo=_get_timezone(tz))
 
 
-_re_interval_sql_standard = regex(
+_re_interval_sql_standard = _LazyRegex(
     '(?:([+-])?([0-9]+)-([0-9]+) ?)?'
     '(?:([+-]?[0-9]+)(?!:) ?)?'
     '(?:([+-])?([0-9]+):([0-9]+):([0-9]+)(?:\\.([0-9]+))?)?')
 
-_re_interval_postgres = regex(
+_re_interval_postgres = _LazyRegex(
     '(?:([+-]?[0-9]+) ?years? ?)?'
     '(?:([+-]?[0-9]+) ?mons? ?)?'
     '(?:([+-]?[0-9]+) ?days? ?)?'
     '(?:([+-])?([0-9]+):([0-9]+):([0-9]+)(?:\\.([0-9]+))?)?')
 
-_re_interval_postgres_verbose = regex(
+_re_interval_postgres_verbose = _LazyRegex(
     '@ ?(?:([+-]?[0-9]+) ?years? ?)?'
     '(?:([+-]?[0-9]+) ?mons? ?)?'
     '(?:([+-]?[0-9]+) ?days? ?)?'
@@ -982,7 +1006,7 @@ _re_interval_postgres_verbose = regex(
     '(?:([+-]?[0-9]+) ?mins? ?)?'
     '(?:([+-])?([0-9]+)(?:\\.([0-9]+))? ?secs?)? ?(ago)?')
 
-_re_interval_iso_8601 = regex(
+_re_interval_iso_8601 = _LazyRegex(
     'P(?:([+-]?[0-9]+)Y)?'
     '(?:([+-]?[0-9]+)M)?'
     '(?:([+-]?[0-9]+)D)?'
@@ -1359,7 +1383,7 @@ class DbTypes(dict):
         return cast(value)
 
 
-_re_fieldname = regex('^[A-Za-z][_a-zA-Z0-9]*$')
+_re_fieldname = _LazyRegex('^[A-Za-z][_a-zA-Z0-9]*$')
 
 
 # The result rows for database operations are returned as named tuples
@@ -1628,11 +1652,16 @@ class DB:
         self.db = db
         self.dbname = db.db
         self._regtypes = False
-        self._attnames = {}
         self._pkeys = {}
         self._privileges = {}
         self.adapter = Adapter(self)
         self.dbtypes = DbTypes(self)
+        # attribute names are kept in a process-wide cache shared between
+        # all connections to the same database, so reconnecting does not
+        # query the catalogs again for already discovered tables
+        self._metadata = get_shared_cache('%s:%s/%s@%s' % (
+            db.host or 'localhost', db.port, self.dbname, db.user))
+        self._attnames = self._get_shared_attnames()
         if db.server_version < 80400:
             # very old remote databases (not officially supported)
             self._query_attnames = (
@@ -1707,6 +1736,15 @@ class DB:
 
     # Auxiliary methods
 
+    def _get_shared_attnames(self):
+        """Get the shared attnames cache for this database.
+
+        Since the cached attribute names depend on whether registered
+        type names are used, both modes get their own shared cache.
+        """
+        key = 'attnames:regtypes' if self.dbtypes._regtypes else 'attnames'
+        return self._metadata.setdefault(key, {})
+
     def _do_debug(self, *args):
         """Print a debug message"""
         if self.debug:
@@ -2162,7 +2200,9 @@ class DB:
 
         If flush is set, then the internal cache for attribute names will
         be flushed. This may be necessary after the database schema or
-        the search path has been changed.
+        the search path has been changed.  Note that the cache is shared
+        between all connections to the same database in this process, so
+        flushing it affects the other connections as well.
 
         By default, only a limited number of simple types will be returned.
         You can get the registered types after calling use_regtypes(True).
@@ -2193,7 +2233,9 @@ class DB:
             regtypes = bool(regtypes)
             if regtypes != self.dbtypes._regtypes:
                 self.dbtypes._regtypes = regtypes
-                self._attnames.clear()
+                # switch to the shared attnames cache for the new mode,
+                # leaving the cache for the other mode intact
+                self._attnames = self._get_shared_attnames()
                 self.dbtypes.clear()
             return regtypes
 
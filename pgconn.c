@@ -8,10 +8,52 @@
  * Please see the LICENSE.TXT file for specific restrictions.
  */
 
+/* Free all entries of the prepared-statement cache of the connection.
+   No DEALLOCATE commands are issued since this is used when the
+   connection is reset or closed and the server-side statements are
+   gone anyway. */
+static void
+_conn_stmt_cache_clear(connObject *self)
+{
+    if (self->stmt_cache) {
+        int i;
+
+        for (i = 0; i < self->stmt_cache_used; ++i) {
+            PyMem_Free(self->stmt_cache[i].query);
+            PyMem_Free(self->stmt_cache[i].param_types);
+        }
+        PyMem_Free(self->stmt_cache);
+        self->stmt_cache = NULL;
+    }
+    self->stmt_cache_used = 0;
+}
+
+/* Free the ring buffer with collected notices. */
+static void
+_conn_notice_ring_clear(connObject *self)
+{
+    if (self->notice_ring) {
+        int i;
+
+        for (i = 0; i < self->notice_count; ++i) {
+            free(self->notice_ring[
+                (self->notice_head + i) % self->notice_size]);
+        }
+        free(self->notice_ring);
+        self->notice_ring = NULL;
+    }
+    self->notice_size = 0;
+    self->notice_head = 0;
+    self->notice_count = 0;
+    self->notice_level = 0;
+}
+
 /* Deallocate connection object. */
 static void
 conn_dealloc(connObject *self)
 {
+    _conn_stmt_cache_clear(self);
+    _conn_notice_ring_clear(self);
     if (self->cnx) {
         Py_BEGIN_ALLOW_THREADS
         PQfinish(self->cnx);
@@ -19,6 +61,7 @@ conn_dealloc(connObject *self)
     }
     Py_XDECREF(self->cast_hook);
     Py_XDECREF(self->notice_receiver);
+    Py_XDECREF(self->explain_hook);
     PyObject_Del(self);
 }
 
@@ -131,6 +174,111 @@ _check_cnx_obj(connObject *self)
     return 1;
 }
 
+/* Look up a query in the prepared-statement cache of the connection.
+   Returns the cache entry for the query, creating a new entry with a
+   generated statement name if the query has not been seen yet, in which
+   case is_new is set and the caller must prepare the statement.  The
+   types array holds one parameter type OID per parameter (0 = inferred
+   by the server); when the query is found but was prepared with a
+   different parameter signature, e.g. because binary parameter values
+   of another type are passed now, the entry is recycled so that the
+   statement gets prepared again under a fresh name.  When the cache is
+   full, the least recently used entry is recycled instead.  In both
+   cases the name of the replaced statement is copied to evict_name, so
+   that the caller can deallocate it.  Returns NULL when out of memory. */
+static stmtCacheEntry *
+_conn_stmt_cache_get(connObject *self, const char *query,
+                     const Oid *types, int nparms,
+                     int *is_new, char *evict_name)
+{
+    stmtCacheEntry *entry, *lru = NULL;
+    int i, found = 0;
+
+    *is_new = 0; *evict_name = '\0';
+
+    if (!self->stmt_cache) {
+        self->stmt_cache = (stmtCacheEntry *) PyMem_Malloc(
+            (size_t) self->stmt_cache_size * sizeof(stmtCacheEntry));
+        if (!self->stmt_cache) return NULL;
+        self->stmt_cache_used = 0;
+    }
+
+    for (i = 0, entry = self->stmt_cache;
+         i < self->stmt_cache_used; ++i, ++entry)
+    {
+        if (!strcmp(entry->query, query)) {
+            if (nparms == entry->num_params &&
+                (!nparms || !memcmp(entry->param_types, types,
+                                    (size_t) nparms * sizeof(Oid))))
+            {
+                entry->last_used = ++self->stmt_cache_tick;
+                ++self->stats.cache_hits;
+                return entry;
+            }
+            found = 1; /* recycle the entry with the stale signature */
+            break;
+        }
+        if (!lru || entry->last_used < lru->last_used) lru = entry;
+    }
+
+    if (found) {
+        strcpy(evict_name, entry->name);
+        PyMem_Free(entry->param_types);
+    }
+    else if (self->stmt_cache_used < self->stmt_cache_size) {
+        entry = self->stmt_cache + self->stmt_cache_used;
+        entry->query = NULL;
+    }
+    else { /* cache is full, recycle the least recently used entry */
+        strcpy(evict_name, lru->name);
+        PyMem_Free(lru->query);
+        entry = lru;
+        entry->query = NULL;
+    }
+
+    if (!entry->query) {
+        entry->query = (char *) PyMem_Malloc(strlen(query) + 1);
+        if (!entry->query) {
+            if (entry == lru) { /* drop the recycled entry entirely */
+                *lru = self->stmt_cache[--self->stmt_cache_used];
+            }
+            return NULL;
+        }
+        strcpy(entry->query, query);
+    }
+
+    entry->param_types = NULL;
+    entry->num_params = nparms;
+    if (nparms) {
+        entry->param_types = (Oid *) PyMem_Malloc(
+            (size_t) nparms * sizeof(Oid));
+        if (!entry->param_types) {
+            PyMem_Free(entry->query);
+            /* drop the entry entirely, shifting in the last one */
+            *entry = self->stmt_cache[--self->stmt_cache_used];
+            return NULL;
+        }
+        memcpy(entry->param_types, types, (size_t) nparms * sizeof(Oid));
+    }
+
+    sprintf(entry->name, "pygresql_%lu", ++self->stmt_cache_tick);
+    entry->last_used = self->stmt_cache_tick;
+    if (!found && entry != lru) ++self->stmt_cache_used;
+    *is_new = 1;
+    ++self->stats.cache_misses;
+    return entry;
+}
+
+/* Remove an entry from the prepared-statement cache of the connection,
+   e.g. because the statement could not be prepared on the server. */
+static void
+_conn_stmt_cache_drop(connObject *self, stmtCacheEntry *entry)
+{
+    PyMem_Free(entry->query);
+    PyMem_Free(entry->param_types);
+    *entry = self->stmt_cache[--self->stmt_cache_used];
+}
+
 /* Create source object. */
 static char conn_source__doc__[] =
 "source() -- create a new source object for this connection";
@@ -200,6 +348,17 @@ _conn_non_query_result(int status, PGresult* result, PGconn *cnx)
             PQclear(result);
             Py_INCREF(Py_None);
             return Py_None;
+#ifdef PIPELINE_MODE
+        case PGRES_PIPELINE_SYNC: /* pipeline synchronization point */
+            PQclear(result);
+            Py_INCREF(Py_None);
+            return Py_None;
+        case PGRES_PIPELINE_ABORTED:
+            set_error(OperationalError,
+                "Command skipped because the pipeline was aborted",
+                cnx, result);
+            break;
+#endif /* PIPELINE_MODE */
         default:
             set_error_msg(InternalError, "Unknown result status");
     }
@@ -208,15 +367,127 @@ _conn_non_query_result(int status, PGresult* result, PGconn *cnx)
     return NULL; /* error detected on query */
  }
 
-/* Base method for execution of all different kinds of queries */
+static long _copy_date_days(long y, int m, int d);
+
+/* Encode a query parameter value in the binary wire format used by the
+   extended query protocol, driven by the Python type of the value.
+   On success, sets the parameter type OID, a pointer to the encoded
+   bytes and their length, and returns 1; the bytes are either borrowed
+   from the value object or written to the caller-provided 8-byte
+   scratch buffer.  Returns 0 when the value has no binary encoding and
+   must be sent as text, and -1 on error with the exception set. */
+static int
+_encode_binary_param(PyObject *obj, char *buf,
+                     Oid *type, const char **data, int *length)
+{
+    if (PyBool_Check(obj)) {
+        buf[0] = (char) (obj == Py_True);
+        *type = BOOLOID; *data = buf; *length = 1;
+        return 1;
+    }
+    if (PyInt_Check(obj) || PyLong_Check(obj)) {
+        PY_LONG_LONG v = PyLong_AsLongLong(obj);
+
+        if (v == -1 && PyErr_Occurred()) {
+            if (!PyErr_ExceptionMatches(PyExc_OverflowError)) return -1;
+            PyErr_Clear(); /* does not fit in int8, send as text */
+            return 0;
+        }
+        write_binary_int64(buf, v);
+        *type = INT8OID; *data = buf; *length = 8;
+        return 1;
+    }
+    if (PyFloat_Check(obj)) {
+        union { double d; PY_LONG_LONG i; } u;
+
+        u.d = PyFloat_AS_DOUBLE(obj);
+        write_binary_int64(buf, u.i);
+        *type = FLOAT8OID; *data = buf; *length = 8;
+        return 1;
+    }
+    if (PyBytes_Check(obj)) {
+        Py_ssize_t size = PyBytes_GET_SIZE(obj);
+
+        if (size > INT_MAX) return 0;
+        *type = BYTEAOID; *data = PyBytes_AS_STRING(obj);
+        *length = (int) size;
+        return 1;
+    }
+    if (!PyDateTimeAPI) {
+        PyDateTime_IMPORT;
+        if (!PyDateTimeAPI) return -1;
+    }
+    if (PyDateTime_Check(obj)) {
+        PY_LONG_LONG usecs;
+        PyObject *offset;
+
+        usecs = _copy_date_days(
+            PyDateTime_GET_YEAR(obj), PyDateTime_GET_MONTH(obj),
+            PyDateTime_GET_DAY(obj)) * 86400000000LL +
+            ((PyDateTime_DATE_GET_HOUR(obj) * 60LL +
+            PyDateTime_DATE_GET_MINUTE(obj)) * 60 +
+            PyDateTime_DATE_GET_SECOND(obj)) * 1000000 +
+            PyDateTime_DATE_GET_MICROSECOND(obj);
+        offset = PyObject_CallMethod(obj, "utcoffset", NULL);
+        if (!offset) return -1;
+        if (offset == Py_None) { /* naive datetime */
+            Py_DECREF(offset);
+            *type = TIMESTAMPOID;
+        }
+        else { /* binary timestamps with time zone are passed in UTC */
+            usecs -= (PyDateTime_DELTA_GET_DAYS(offset) * 86400LL +
+                PyDateTime_DELTA_GET_SECONDS(offset)) * 1000000 +
+                PyDateTime_DELTA_GET_MICROSECONDS(offset);
+            Py_DECREF(offset);
+            *type = TIMESTAMPTZOID;
+        }
+        write_binary_int64(buf, usecs);
+        *data = buf; *length = 8;
+        return 1;
+    }
+    if (PyDate_Check(obj)) {
+        write_binary_int32(buf, _copy_date_days(
+            PyDateTime_GET_YEAR(obj), PyDateTime_GET_MONTH(obj),
+            PyDateTime_GET_DAY(obj)));
+        *type = DATEOID; *data = buf; *length = 4;
+        return 1;
+    }
+    if (PyTime_Check(obj)) {
+        PY_LONG_LONG usecs;
+        PyObject *offset = PyObject_CallMethod(obj, "utcoffset", NULL);
+
+        if (!offset) return -1;
+        if (offset != Py_None) { /* send times with time zone as text */
+            Py_DECREF(offset);
+            return 0;
+        }
+        Py_DECREF(offset);
+        usecs = ((PyDateTime_TIME_GET_HOUR(obj) * 60LL +
+            PyDateTime_TIME_GET_MINUTE(obj)) * 60 +
+            PyDateTime_TIME_GET_SECOND(obj)) * 1000000 +
+            PyDateTime_TIME_GET_MICROSECOND(obj);
+        write_binary_int64(buf, usecs);
+        *type = TIMEOID; *data = buf; *length = 8;
+        return 1;
+    }
+    return 0; /* all other values are sent as text */
+}
+
+/* Base method for execution of all different kinds of queries.
+   The fmt parameter specifies the requested result format
+   (0 = text, 1 = binary wire format).  If stream is set, the query
+   is sent in single-row mode so that the result set can be iterated
+   over row by row with bounded memory. */
 static PyObject *
-_conn_query(connObject *self, PyObject *args, int prepared, int async)
+_conn_query(connObject *self, PyObject *args, int prepared, int async,
+            int fmt, int stream)
 {
     PyObject *query_str_obj, *param_obj = NULL;
     PGresult* result;
     queryObject* query_obj;
     char *query;
     int encoding, status, nparms = 0;
+    double t0, elapsed;
 
     if (!self->cnx) {
         PyErr_SetString(PyExc_TypeError, "Connection is not valid");
@@ -275,31 +546,63 @@ _conn_query(connObject *self, PyObject *args, int prepared, int async)
         /* prepare arguments */
         PyObject **str, **s;
         const char **parms, **p;
+        char *extra, *bin;
+        Oid *types;
+        int *lens, *fmts;
+        stmtCacheEntry *cached = NULL;
+        int new_stmt = 0, prepare_failed = 0, have_binary = 0;
+        char evict_name[32];
         register int i;
 
         str = (PyObject **) PyMem_Malloc((size_t) nparms * sizeof(*str));
         parms = (const char **) PyMem_Malloc((size_t) nparms * sizeof(*parms));
-        if (!str || !parms) {
-            PyMem_Free((void *) parms); PyMem_Free(str);
+        /* one block for the parameter types, lengths and formats plus
+         * 8 bytes of scratch per parameter for binary-encoded scalars */
+        extra = (char *) PyMem_Malloc(
+            (size_t) nparms * (sizeof(Oid) + 2 * sizeof(int) + 8));
+        if (!str || !parms || !extra) {
+            PyMem_Free(extra); PyMem_Free((void *) parms); PyMem_Free(str);
             Py_XDECREF(query_str_obj); Py_XDECREF(param_obj);
             return PyErr_NoMemory();
         }
+        types = (Oid *) extra;
+        lens = (int *) (types + nparms);
+        fmts = lens + nparms;
+        bin = (char *) (fmts + nparms);
 
         /* convert optional args to a list of strings -- this allows
          * the caller to pass whatever they like, and prevents us
-         * from having to map types to OIDs */
+         * from having to map types to OIDs -- unless binary parameter
+         * encoding is enabled, in which case scalar values of types
+         * with an unambiguous wire format are sent in binary form */
         for (i = 0, s = str, p = parms; i < nparms; ++i, ++p) {
             PyObject *obj = PySequence_Fast_GET_ITEM(param_obj, i);
 
+            types[i] = 0; lens[i] = 0; fmts[i] = 0;
             if (obj == Py_None) {
                 *p = NULL;
             }
+            else if (binary_params && !prepared &&
+                     (fmts[i] = _encode_binary_param(
+                         obj, bin + 8 * i, types + i, p, lens + i)) != 0)
+            {
+                if (fmts[i] < 0) {
+                    PyMem_Free(extra); PyMem_Free((void *) parms);
+                    while (s != str) { s--; Py_DECREF(*s); }
+                    PyMem_Free(str);
+                    Py_XDECREF(query_str_obj);
+                    Py_XDECREF(param_obj);
+                    return NULL;
+                }
+                have_binary = 1;
+            }
             else if (PyBytes_Check(obj)) {
                 *p = PyBytes_AsString(obj);
             }
             else if (PyUnicode_Check(obj)) {
                 PyObject *str_obj = get_encoded_string(obj, encoding);
                 if (!str_obj) {
+                    PyMem_Free(extra);
                     PyMem_Free((void *) parms);
                     while (s != str) { s--; Py_DECREF(*s); }
                     PyMem_Free(str);
@@ -314,6 +617,7 @@ _conn_query(connObject *self, PyObject *args, int prepared, int async)
             else {
                 PyObject *str_obj = PyObject_Str(obj);
                 if (!str_obj) {
+                    PyMem_Free(extra);
                     PyMem_Free((void *) parms);
                     while (s != str) { s--; Py_DECREF(*s); }
                     PyMem_Free(str);
@@ -329,40 +633,188 @@ _conn_query(connObject *self, PyObject *args, int prepared, int async)
             }
         }
 
+        /* route the query through the prepared-statement cache */
+        if (!prepared && !async && self->stmt_cache_size > 0) {
+            cached = _conn_stmt_cache_get(self, query, types, nparms,
+                &new_stmt, evict_name);
+            if (!cached) {
+                PyMem_Free(extra);
+                PyMem_Free((void *) parms);
+                while (s != str) { s--; Py_DECREF(*s); }
+                PyMem_Free(str);
+                Py_XDECREF(query_str_obj);
+                Py_XDECREF(param_obj);
+                return PyErr_NoMemory();
+            }
+        }
+
+        t0 = _monotime();
         Py_BEGIN_ALLOW_THREADS
         if (async) {
             status = PQsendQueryParams(self->cnx, query, nparms,
-                NULL, (const char * const *)parms, NULL, NULL, 0);
+                have_binary ? types : NULL, (const char * const *)parms,
+                have_binary ? lens : NULL, have_binary ? fmts : NULL, fmt);
+            result = NULL;
+        }
+        else if (cached) {
             result = NULL;
+            if (*evict_name) {
+                /* deallocate the evicted statement on the server */
+                char cmd[48];
+                PGresult *res;
+
+                sprintf(cmd, "DEALLOCATE %s", evict_name);
+                if ((res = PQexec(self->cnx, cmd))) PQclear(res);
+            }
+            if (new_stmt) {
+                PGresult *res = PQprepare(
+                    self->cnx, cached->name, query, nparms,
+                    have_binary ? types : NULL);
+
+                if (res && PQresultStatus(res) == PGRES_COMMAND_OK) {
+                    PQclear(res);
+                }
+                else { /* pass the error on as the query result */
+                    result = res;
+                    prepare_failed = 1;
+                }
+            }
+            if (!prepare_failed) {
+                result = PQexecPrepared(self->cnx, cached->name, nparms,
+                    parms, have_binary ? lens : NULL,
+                    have_binary ? fmts : NULL, fmt);
+                if (result && !new_stmt &&
+                    PQresultStatus(result) == PGRES_FATAL_ERROR)
+                {
+                    /* If the server has lost the statement, e.g. because
+                       the transaction that prepared it was rolled back,
+                       prepare it again and retry the execution once. */
+                    const char *sqlstate = PQresultErrorField(
+                        result, PG_DIAG_SQLSTATE);
+
+                    if (sqlstate && !strcmp(sqlstate, "26000")) {
+                        PGresult *res = PQprepare(
+                            self->cnx, cached->name, query, nparms,
+                            have_binary ? types : NULL);
+
+                        if (res && PQresultStatus(res) == PGRES_COMMAND_OK) {
+                            PQclear(res);
+                            PQclear(result);
+                            result = PQexecPrepared(self->cnx, cached->name,
+                                nparms, parms, have_binary ? lens : NULL,
+                                have_binary ? fmts : NULL, fmt);
+                        }
+                        else {
+                            if (res) PQclear(res);
+                            prepare_failed = 1;
+                        }
+                    }
+                }
+            }
+            status = result != NULL;
         }
         else {
             result = prepared ?
                 PQexecPrepared(self->cnx, query, nparms,
-                    parms, NULL, NULL, 0) :
+                    parms, NULL, NULL, fmt) :
                 PQexecParams(self->cnx, query, nparms,
-                    NULL, parms, NULL, NULL, 0);
+                    have_binary ? types : NULL, parms,
+                    have_binary ? lens : NULL,
+                    have_binary ? fmts : NULL, fmt);
             status = result != NULL;
         }
         Py_END_ALLOW_THREADS
+        elapsed = _monotime() - t0;
+        self->stats.server_time += elapsed;
+
+        if (prepare_failed) {
+            /* remove the statement that could not be prepared */
+            _conn_stmt_cache_drop(self, cached);
+        }
 
+        PyMem_Free(extra);
         PyMem_Free((void *) parms);
         while (s != str) { s--; Py_DECREF(*s); }
         PyMem_Free(str);
     }
     else {
+        t0 = _monotime();
         Py_BEGIN_ALLOW_THREADS
         if (async) {
-            status = PQsendQuery(self->cnx, query);
+            /* a binary result format can only be requested with the
+               extended query protocol, i.e. PQsendQueryParams();
+               the same holds for queries sent in pipeline mode */
+            int extended = fmt;
+#ifdef PIPELINE_MODE
+            if (PQpipelineStatus(self->cnx) != PQ_PIPELINE_OFF)
+                extended = 1;
+#endif /* PIPELINE_MODE */
+            status = extended ? PQsendQueryParams(self->cnx, query, 0,
+                    NULL, NULL, NULL, NULL, fmt) :
+                PQsendQuery(self->cnx, query);
             result = NULL;
         }
         else {
             result = prepared ?
                 PQexecPrepared(self->cnx, query, 0,
-                    NULL, NULL, NULL, 0) :
+                    NULL, NULL, NULL, fmt) :
+                fmt ? PQexecParams(self->cnx, query, 0,
+                    NULL, NULL, NULL, NULL, fmt) :
                 PQexec(self->cnx, query);
             status = result != NULL;
         }
         Py_END_ALLOW_THREADS
+        elapsed = _monotime() - t0;
+        self->stats.server_time += elapsed;
+    }
+    ++self->stats.queries;
+
+    if (self->explain_hook && !async && !prepared && !param_obj
+        && elapsed >= self->explain_threshold && result
+        && (PQresultStatus(result) == PGRES_TUPLES_OK
+            || PQresultStatus(result) == PGRES_COMMAND_OK)
+        /* a semicolon could hide a second statement that PQexec()
+           would execute again, so such statements are not explained */
+        && !strchr(query, ';'))
+    {
+        /* sample the plan of a statement exceeding the threshold */
+        char *explain = PyMem_Malloc(strlen(query) + 24);
+
+        if (explain) {
+            PGresult *res;
+
+            sprintf(explain, "EXPLAIN (FORMAT JSON) %s", query);
+            Py_BEGIN_ALLOW_THREADS
+            res = PQexec(self->cnx, explain);
+            Py_END_ALLOW_THREADS
+            PyMem_Free(explain);
+            if (res) {
+                if (PQresultStatus(res) == PGRES_TUPLES_OK
+                    && PQntuples(res) == 1)
+                {
+                    /* temporarily unset the hook so that queries run
+                       by the hook itself cannot trigger it again */
+                    PyObject *hook = self->explain_hook, *ret;
+
+                    self->explain_hook = NULL;
+                    ret = PyObject_CallFunction(hook, "(sds)",
+                        query, elapsed, PQgetvalue(res, 0, 0));
+                    if (!self->explain_hook)
+                        self->explain_hook = hook;
+                    else
+                        Py_DECREF(hook);
+                    if (!ret) {
+                        PQclear(res);
+                        PQclear(result);
+                        Py_XDECREF(query_str_obj);
+                        Py_XDECREF(param_obj);
+                        return NULL; /* pass the error from the hook */
+                    }
+                    Py_DECREF(ret);
+                }
+                PQclear(res);
+            }
+        }
     }
 
     /* we don't need the query and its params any more */
@@ -375,6 +827,12 @@ _conn_query(connObject *self, PyObject *args, int prepared, int async)
         return NULL;
     }
 
+    /* activate single-row mode for streaming queries */
+    if (stream && !PQsetSingleRowMode(self->cnx)) {
+        set_error_msg(InternalError, "Cannot activate single-row mode");
+        return NULL;
+    }
+
     /* this may have changed the datestyle, so we reset the date format
        in order to force fetching it newly when next time requested */
     self->date_format = date_format; /* this is normally NULL */
@@ -391,8 +849,22 @@ _conn_query(connObject *self, PyObject *args, int prepared, int async)
     query_obj->pgcnx = self;
     query_obj->result = result;
     query_obj->async = async;
+    query_obj->streaming = stream;
     query_obj->encoding = encoding;
     query_obj->current_row = 0;
+    query_obj->named_row_type = NULL;
+    query_obj->intern_cache = NULL;
+    memset(&query_obj->arena, 0, sizeof(query_obj->arena));
+    if (self->query_capture && !async) {
+        char *ct = PQcmdTuples(result);
+
+        query_obj->elapsed = elapsed;
+        query_obj->rows_affected = *ct ? atol(ct) : -1;
+    }
+    else {
+        query_obj->elapsed = -1;
+        query_obj->rows_affected = -1;
+    }
     if (async) {
         query_obj->max_row = 0;
         query_obj->num_fields = 0;
@@ -421,7 +893,34 @@ static char conn_query__doc__[] =
 static PyObject *
 conn_query(connObject *self, PyObject *args)
 {
-    return _conn_query(self, args, 0, 0);
+    return _conn_query(self, args, 0, 0, 0, 0);
+}
+
+/* Database query with binary results */
+static char conn_query_binary__doc__[] =
+"query_binary(sql, [arg]) -- create a new query object for this connection\n\n"
+"Works like the query() method, but requests the results in binary format\n"
+"so that numeric values are converted without a text round-trip.\n"
+"Values of types without a binary cast are returned as raw bytes.\n";
+
+static PyObject *
+conn_query_binary(connObject *self, PyObject *args)
+{
+    return _conn_query(self, args, 0, 0, 1, 0);
+}
+
+/* Streaming database query */
+static char conn_query_streaming__doc__[] =
+"query_streaming(sql, [arg]) -- create a streaming query object\n\n"
+"Works like the query() method, but executes the query in single-row\n"
+"mode: iterating over the returned query object fetches the rows as\n"
+"they arrive from the server, keeping only one row at a time in memory\n"
+"instead of materializing the whole result set.\n";
+
+static PyObject *
+conn_query_streaming(connObject *self, PyObject *args)
+{
+    return _conn_query(self, args, 0, 1, 0, 1);
 }
 
 /* Asynchronous database query */
@@ -433,8 +932,61 @@ static char conn_send_query__doc__[] =
 static PyObject *
 conn_send_query(connObject *self, PyObject *args)
 {
-    return _conn_query(self, args, 0, 1);
+    return _conn_query(self, args, 0, 1, 0, 0);
+}
+
+#if IS_PY3
+/* Create an awaitable asynchronous query. */
+static char conn_query_async__doc__[] =
+"query_async(sql, [arg]) -- create an awaitable query for this connection\n\n"
+"You must pass the SQL (string) request and you can optionally pass\n"
+"a tuple with positional parameters.  The result is an awaitable that\n"
+"drives the query off the running asyncio event loop without blocking\n"
+"it and that resolves to the finished query object.\n";
+
+static PyObject *
+conn_query_async(connObject *self, PyObject *args)
+{
+    asyncQueryObject *async_query;
+    PyObject *query;
+    int nonblocking;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    /* the query must be sent in non-blocking mode so that neither
+       sending nor flushing can block the event loop thread */
+    nonblocking = PQisnonblocking(self->cnx);
+    if (!nonblocking && PQsetnonblocking(self->cnx, 1) == -1) {
+        PyErr_SetString(OperationalError, PQerrorMessage(self->cnx));
+        return NULL;
+    }
+
+    if (!(query = _conn_query(self, args, 0, 1, 0, 0))) {
+        if (!nonblocking) PQsetnonblocking(self->cnx, 0);
+        return NULL;
+    }
+
+    if (!(async_query = PyObject_New(asyncQueryObject, &asyncQueryType))) {
+        Py_DECREF(query);
+        if (!nonblocking) PQsetnonblocking(self->cnx, 0);
+        return NULL;
+    }
+    Py_INCREF(self);
+    async_query->pgcnx = self;
+    async_query->query = (queryObject *) query;
+    async_query->loop = NULL;
+    async_query->wake = NULL;
+    async_query->future = NULL;
+    async_query->fd = PQsocket(self->cnx);
+    async_query->watching = 0;
+    async_query->state = 0;
+    async_query->nonblocking = nonblocking;
+    return (PyObject *) async_query;
 }
+#endif /* IS_PY3 */
 
 /* Execute prepared statement. */
 static char conn_query_prepared__doc__[] =
@@ -445,7 +997,263 @@ static char conn_query_prepared__doc__[] =
 static PyObject *
 conn_query_prepared(connObject *self, PyObject *args)
 {
-    return _conn_query(self, args, 1, 0);
+    return _conn_query(self, args, 1, 0, 0, 0);
+}
+
+/* Execute a statement for a whole batch of parameter tuples. */
+static char conn_executemany__doc__[] =
+"executemany(sql, params) -- execute a statement for many parameters\n\n"
+"You must pass the SQL (string) request using positional parameters\n"
+"($1, $2, ...) and a sequence of tuples with the parameter values.\n"
+"The statement is prepared once and executed for all the tuples in\n"
+"a single batch using the pipeline mode of the server if available,\n"
+"so the number of server round trips does not grow with the number\n"
+"of tuples.  The total number of affected rows is returned.\n";
+
+static PyObject *
+conn_executemany(connObject *self, PyObject *args)
+{
+    PyObject *query_str_obj, *seq_obj, *seq;
+    PGresult *error_result = NULL;
+    PyObject **str, **s;
+    const char **parms;
+    char *query;
+    long total = 0;
+    Py_ssize_t nrows, row;
+    int encoding, nparms = 0, failed = 0;
+    double t0;
+    register int i;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    /* get query args */
+    if (!PyArg_ParseTuple(args, "OO", &query_str_obj, &seq_obj)) {
+        return NULL;
+    }
+
+    encoding = PQclientEncoding(self->cnx);
+
+    if (PyBytes_Check(query_str_obj)) {
+        query = PyBytes_AsString(query_str_obj);
+        query_str_obj = NULL;
+    }
+    else if (PyUnicode_Check(query_str_obj)) {
+        query_str_obj = get_encoded_string(query_str_obj, encoding);
+        if (!query_str_obj) return NULL; /* pass the UnicodeEncodeError */
+        query = PyBytes_AsString(query_str_obj);
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method executemany() expects"
+                        " a string as first argument");
+        return NULL;
+    }
+
+    if (!(seq = PySequence_Fast(seq_obj,
+        "Method executemany() expects a sequence as second argument")))
+    {
+        Py_XDECREF(query_str_obj);
+        return NULL;
+    }
+    nrows = PySequence_Fast_GET_SIZE(seq);
+    if (!nrows) { /* nothing to do without parameters */
+        Py_DECREF(seq); Py_XDECREF(query_str_obj);
+        return PyInt_FromLong(0);
+    }
+
+#ifdef PIPELINE_MODE
+    if (PQpipelineStatus(self->cnx) != PQ_PIPELINE_OFF) {
+        Py_DECREF(seq); Py_XDECREF(query_str_obj);
+        PyErr_SetString(PyExc_IOError,
+                        "Method executemany() cannot be used"
+                        " while the connection is in pipeline mode");
+        return NULL;
+    }
+#endif /* PIPELINE_MODE */
+
+    /* convert all parameters to strings up front, as one contiguous
+       block of value pointers, in the same way as a single query with
+       parameters does */
+    {
+        PyObject *first = PySequence_Fast_GET_ITEM(seq, 0);
+
+        if (PyTuple_Check(first) || PyList_Check(first)) {
+            nparms = (int) PySequence_Size(first);
+        }
+        else {
+            Py_DECREF(seq); Py_XDECREF(query_str_obj);
+            PyErr_SetString(PyExc_TypeError,
+                            "Method executemany() expects a sequence"
+                            " of tuples as second argument");
+            return NULL;
+        }
+    }
+
+    str = (PyObject **) PyMem_Malloc(
+        (size_t) nrows * (size_t) nparms * sizeof(*str) + sizeof(*str));
+    parms = (const char **) PyMem_Malloc(
+        (size_t) nrows * (size_t) nparms * sizeof(*parms) + sizeof(*parms));
+    if (!str || !parms) {
+        PyMem_Free((void *) parms); PyMem_Free(str);
+        Py_DECREF(seq); Py_XDECREF(query_str_obj);
+        return PyErr_NoMemory();
+    }
+    s = str;
+
+    for (row = 0; row < nrows; ++row) {
+        PyObject *row_obj = PySequence_Fast_GET_ITEM(seq, row);
+        const char **p = parms + row * nparms;
+
+        if (!(PyTuple_Check(row_obj) || PyList_Check(row_obj))
+            || PySequence_Size(row_obj) != nparms)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                            "The parameter tuples passed to executemany()"
+                            " must all have the same length");
+            goto encode_error;
+        }
+
+        for (i = 0; i < nparms; ++i, ++p) {
+            PyObject *obj = PySequence_GetItem(row_obj, i);
+
+            if (!obj) goto encode_error;
+            if (obj == Py_None) {
+                *p = NULL; Py_DECREF(obj);
+            }
+            else if (PyBytes_Check(obj)) {
+                *s++ = obj; /* keep the reference */
+                *p = PyBytes_AsString(obj);
+            }
+            else if (PyUnicode_Check(obj)) {
+                PyObject *str_obj = get_encoded_string(obj, encoding);
+
+                Py_DECREF(obj);
+                if (!str_obj) goto encode_error;
+                *s++ = str_obj;
+                *p = PyBytes_AsString(str_obj);
+            }
+            else {
+                PyObject *str_obj = PyObject_Str(obj);
+
+                Py_DECREF(obj);
+                if (!str_obj) {
+                    PyErr_SetString(
+                        PyExc_TypeError,
+                        "Query parameter has no string representation");
+                    goto encode_error;
+                }
+                *s++ = str_obj;
+                *p = PyStr_AsString(str_obj);
+            }
+        }
+    }
+
+    /* prepare the statement once and execute it for all tuples;
+       in pipeline mode everything is flushed to the server in one
+       batch, otherwise we at least save the repeated query parsing */
+    t0 = _monotime();
+    Py_BEGIN_ALLOW_THREADS
+#ifdef PIPELINE_MODE
+    if (PQenterPipelineMode(self->cnx)) {
+        PGresult *result;
+        int status;
+
+        failed = !PQsendPrepare(self->cnx, "", query, nparms, NULL);
+        for (row = 0; !failed && row < nrows; ++row) {
+            failed = !PQsendQueryPrepared(self->cnx, "", nparms,
+                parms + row * nparms, NULL, NULL, 0);
+        }
+        if (!failed) failed = !PQpipelineSync(self->cnx);
+
+        /* collect all results up to the synchronization point */
+        while (!failed) {
+            if (!(result = PQgetResult(self->cnx))) {
+                if (PQstatus(self->cnx) == CONNECTION_BAD) {
+                    failed = 1; break;
+                }
+                continue; /* between two statements */
+            }
+            status = PQresultStatus(result);
+            if (status == PGRES_PIPELINE_SYNC) {
+                PQclear(result); break;
+            }
+            if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK) {
+                total += atol(PQcmdTuples(result));
+                PQclear(result);
+            }
+            else if (status == PGRES_PIPELINE_ABORTED) {
+                PQclear(result); /* skipped after the failed statement */
+            }
+            else if (!error_result) {
+                error_result = result; /* keep the first error */
+            }
+            else {
+                PQclear(result);
+            }
+        }
+        PQexitPipelineMode(self->cnx);
+    }
+    else {
+        failed = 1;
+    }
+#else /* PIPELINE_MODE */
+    {
+        PGresult *result = PQprepare(self->cnx, "", query, nparms, NULL);
+
+        if (result && PQresultStatus(result) == PGRES_COMMAND_OK) {
+            PQclear(result);
+            for (row = 0; row < nrows; ++row) {
+                result = PQexecPrepared(self->cnx, "", nparms,
+                    parms + row * nparms, NULL, NULL, 0);
+                if (result && (PQresultStatus(result) == PGRES_COMMAND_OK ||
+                               PQresultStatus(result) == PGRES_TUPLES_OK))
+                {
+                    total += atol(PQcmdTuples(result));
+                    PQclear(result);
+                }
+                else {
+                    error_result = result;
+                    break;
+                }
+            }
+        }
+        else {
+            error_result = result;
+        }
+        if (!error_result && !result) failed = 1;
+    }
+#endif /* PIPELINE_MODE */
+    Py_END_ALLOW_THREADS
+    self->stats.server_time += _monotime() - t0;
+    self->stats.queries += (unsigned long) nrows;
+
+    while (s != str) { s--; Py_DECREF(*s); }
+    PyMem_Free(str);
+    PyMem_Free((void *) parms);
+    Py_DECREF(seq);
+    Py_XDECREF(query_str_obj);
+
+    if (error_result) {
+        return _conn_non_query_result(
+            PQresultStatus(error_result), error_result, self->cnx);
+    }
+    if (failed) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        return NULL;
+    }
+
+    return PyInt_FromLong(total);
+
+encode_error:
+    while (s != str) { s--; Py_DECREF(*s); }
+    PyMem_Free(str);
+    PyMem_Free((void *) parms);
+    Py_DECREF(seq);
+    Py_XDECREF(query_str_obj);
+    return NULL;
 }
 
 /* Create prepared statement. */
@@ -526,8 +1334,15 @@ conn_describe_prepared(connObject *self, PyObject *args)
         Py_XINCREF(self);
         query_obj->pgcnx = self;
         query_obj->result = result;
+        query_obj->async = 0;
+        query_obj->streaming = 0;
         query_obj->encoding = PQclientEncoding(self->cnx);
         query_obj->current_row = 0;
+        query_obj->named_row_type = NULL;
+        query_obj->intern_cache = NULL;
+        memset(&query_obj->arena, 0, sizeof(query_obj->arena));
+        query_obj->elapsed = -1;
+        query_obj->rows_affected = -1;
         query_obj->max_row = PQntuples(result);
         query_obj->num_fields = PQnfields(result);
         query_obj->col_types = get_col_types(result, query_obj->num_fields);
@@ -540,15 +1355,184 @@ conn_describe_prepared(connObject *self, PyObject *args)
     return NULL; /* error */
 }
 
-#ifdef DIRECT_ACCESS
-static char conn_putline__doc__[] =
-"putline(line) -- send a line directly to the backend";
+/* Get the size of the prepared-statement cache. */
+static char conn_get_statement_cache_size__doc__[] =
+"get_statement_cache_size() -- get size of the statement cache\n\n"
+"Returns the maximum number of parameterized queries that are\n"
+"automatically cached as server-side prepared statements.\n";
 
-/* Direct access function: putline. */
 static PyObject *
-conn_putline(connObject *self, PyObject *args)
+conn_get_statement_cache_size(connObject *self, PyObject *noargs)
 {
-    char *line;
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    return PyInt_FromLong(self->stmt_cache_size);
+}
+
+/* Set the size of the prepared-statement cache. */
+static char conn_set_statement_cache_size__doc__[] =
+"set_statement_cache_size(num) -- set size of the statement cache\n\n"
+"Sets the maximum number of parameterized queries that are\n"
+"automatically cached as server-side prepared statements.\n"
+"A size of 0 disables the cache.  All currently cached statements\n"
+"are deallocated when the size is changed.\n";
+
+static PyObject *
+conn_set_statement_cache_size(connObject *self, PyObject *args)
+{
+    int size;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "i", &size)) {
+        PyErr_SetString(
+            PyExc_TypeError,
+            "Method set_statement_cache_size() expects an integer argument");
+        return NULL;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Statement cache size must not be negative");
+        return NULL;
+    }
+
+    /* deallocate the currently cached statements on the server */
+    if (self->stmt_cache) {
+        int i;
+
+        Py_BEGIN_ALLOW_THREADS
+        for (i = 0; i < self->stmt_cache_used; ++i) {
+            char cmd[48];
+            PGresult *res;
+
+            sprintf(cmd, "DEALLOCATE %s", self->stmt_cache[i].name);
+            if ((res = PQexec(self->cnx, cmd))) PQclear(res);
+        }
+        Py_END_ALLOW_THREADS
+    }
+    _conn_stmt_cache_clear(self);
+    self->stmt_cache_size = size;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+#ifdef PIPELINE_MODE
+
+/* Enter pipeline mode. */
+static char conn_enter_pipeline_mode__doc__[] =
+"enter_pipeline_mode() -- switch the connection into pipeline mode\n\n"
+"In pipeline mode, statements sent with send_query() are queued and\n"
+"flushed to the server in one batch when pipeline_sync() is called.\n"
+"The results can then be fetched from the query objects in order.\n";
+
+static PyObject *
+conn_enter_pipeline_mode(connObject *self, PyObject *noargs)
+{
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PQenterPipelineMode(self->cnx)) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        return NULL;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Exit pipeline mode. */
+static char conn_exit_pipeline_mode__doc__[] =
+"exit_pipeline_mode() -- switch the connection out of pipeline mode\n\n"
+"All queued statements must have been synced before; any results\n"
+"that have not yet been fetched will be discarded.\n";
+
+static PyObject *
+conn_exit_pipeline_mode(connObject *self, PyObject *noargs)
+{
+    PGresult *result;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    /* discard any pending results, including synchronization points */
+    Py_BEGIN_ALLOW_THREADS
+    while ((result = PQgetResult(self->cnx))) {
+        PQclear(result);
+    }
+    Py_END_ALLOW_THREADS
+
+    if (!PQexitPipelineMode(self->cnx)) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        return NULL;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Mark a synchronization point in a pipeline. */
+static char conn_pipeline_sync__doc__[] =
+"pipeline_sync() -- mark a synchronization point in a pipeline\n\n"
+"This flushes all statements queued since the last synchronization\n"
+"point to the server in a single batch.\n";
+
+static PyObject *
+conn_pipeline_sync(connObject *self, PyObject *noargs)
+{
+    int res;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    res = PQpipelineSync(self->cnx);
+    Py_END_ALLOW_THREADS
+
+    if (!res) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        return NULL;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Get the current pipeline mode status. */
+static char conn_pipeline_status__doc__[] =
+"pipeline_status() -- return the current pipeline mode status";
+
+static PyObject *
+conn_pipeline_status(connObject *self, PyObject *noargs)
+{
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    return PyInt_FromLong(PQpipelineStatus(self->cnx));
+}
+
+#endif /* PIPELINE_MODE */
+
+#ifdef DIRECT_ACCESS
+static char conn_putline__doc__[] =
+"putline(line) -- send a line directly to the backend";
+
+/* Direct access function: putline. */
+static PyObject *
+conn_putline(connObject *self, PyObject *args)
+{
+    char *line;
     Py_ssize_t line_length;
 
     if (!self->cnx) {
@@ -865,84 +1849,675 @@ conn_inserttable(connObject *self, PyObject *args)
                     *bufpt++ = *t++; --bufsiz;
                 }
             }
-            else if (PyUnicode_Check(item)) {
-                PyObject *s = get_encoded_string(item, encoding);
-                if (!s) {
-                    PyMem_Free(buffer);
+            else if (PyUnicode_Check(item)) {
+                PyObject *s = get_encoded_string(item, encoding);
+                if (!s) {
+                    PyMem_Free(buffer);
+                    return NULL; /* pass the UnicodeEncodeError */
+                }
+                else {
+                    const char* t = PyBytes_AsString(s);
+
+                    while (*t && bufsiz) {
+                        if (*t == '\\' || *t == '\t' || *t == '\n') {
+                            *bufpt++ = '\\'; --bufsiz;
+                            if (!bufsiz) break;
+                        }
+                        *bufpt++ = *t++; --bufsiz;
+                    }
+                    Py_DECREF(s);
+                }
+            }
+            else if (PyInt_Check(item) || PyLong_Check(item)) {
+                PyObject* s = PyObject_Str(item);
+                const char* t = PyStr_AsString(s);
+
+                while (*t && bufsiz) {
+                    *bufpt++ = *t++; --bufsiz;
+                }
+                Py_DECREF(s);
+            }
+            else {
+                PyObject* s = PyObject_Repr(item);
+                const char* t = PyStr_AsString(s);
+
+                while (*t && bufsiz) {
+                    if (*t == '\\' || *t == '\t' || *t == '\n') {
+                        *bufpt++ = '\\'; --bufsiz;
+                        if (!bufsiz) break;
+                    }
+                    *bufpt++ = *t++; --bufsiz;
+                }
+                Py_DECREF(s);
+            }
+
+            if (bufsiz <= 0) {
+                PyMem_Free(buffer); return PyErr_NoMemory();
+            }
+
+        }
+
+        *bufpt++ = '\n'; *bufpt = '\0';
+
+        /* sends data */
+        if (PQputline(self->cnx, buffer)) {
+            PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+            PQendcopy(self->cnx);
+            PyMem_Free(buffer);
+            return NULL;
+        }
+        ++self->stats.rows;
+        self->stats.bytes += (unsigned PY_LONG_LONG) (bufpt - buffer);
+    }
+
+    /* ends query */
+    if (PQputline(self->cnx, "\\.\n")) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        PQendcopy(self->cnx);
+        PyMem_Free(buffer);
+        return NULL;
+    }
+
+    if (PQendcopy(self->cnx)) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+        PyMem_Free(buffer);
+        return NULL;
+    }
+
+    PyMem_Free(buffer);
+
+    /* no error : returns nothing */
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Ensure that the copy buffer has room for the given number of
+   additional bytes, growing it if necessary.  Returns a pointer to the
+   reserved region and advances the length, or NULL when out of memory. */
+static char *
+_copy_buf_reserve(char **buf, size_t *len, size_t *size, size_t add)
+{
+    char *ptr;
+
+    if (*len + add > *size) {
+        size_t new_size = *size;
+        char *new_buf;
+
+        while (*len + add > new_size) new_size <<= 1;
+        if (!(new_buf = (char *) PyMem_Realloc(*buf, new_size))) {
+            return NULL;
+        }
+        *buf = new_buf; *size = new_size;
+    }
+    ptr = *buf + *len; *len += add;
+    return ptr;
+}
+
+/* Return the number of days between 2000-01-01 (the PostgreSQL epoch)
+   and the given calendar date. */
+static long
+_copy_date_days(long y, int m, int d)
+{
+    long era, yoe, doy, doe;
+
+    y -= m <= 2;
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = y - era * 400;
+    doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 730425;
+}
+
+/* Append a numeric value given in decimal string representation to the
+   copy buffer in binary wire format.  Unparsable values are sent as NaN.
+   Returns 0 on success, -1 when out of memory. */
+static int
+_copy_add_numeric(const char *s, char **buf, size_t *len, size_t *size)
+{
+    const char *ip, *fp;
+    int ilen, flen, offset, ndigits, weight, dscale, sign = 0;
+    int i, digit;
+    char *cp;
+
+    if (*s == '+') ++s;
+    else if (*s == '-') { sign = 0x4000; ++s; }
+    ip = s;
+    while (*s >= '0' && *s <= '9') ++s;
+    ilen = (int) (s - ip);
+    if (*s == '.') {
+        fp = ++s;
+        while (*s >= '0' && *s <= '9') ++s;
+        flen = (int) (s - fp);
+    }
+    else {
+        fp = s; flen = 0;
+    }
+
+    if (*s || !(ilen || flen)) { /* not a plain decimal number, send NaN */
+        if (!(cp = _copy_buf_reserve(buf, len, size, 12))) return -1;
+        write_binary_int32(cp, 8);
+        write_binary_int16(cp + 4, 0); write_binary_int16(cp + 6, 0);
+        write_binary_int16(cp + 8, 0xC000); write_binary_int16(cp + 10, 0);
+        return 0;
+    }
+
+    dscale = flen;
+    while (ilen > 0 && *ip == '0') { ++ip; --ilen; } /* strip leading zeros */
+    offset = (4 - ilen % 4) % 4; /* pad on the left to groups of four */
+    ndigits = (ilen + offset + flen + 3) / 4;
+    weight = (ilen + offset) / 4 - 1;
+
+    if (!(cp = _copy_buf_reserve(buf, len, size, (size_t) (12 + 2 * ndigits))))
+        return -1;
+    write_binary_int32(cp, 8 + 2 * ndigits); cp += 4;
+    write_binary_int16(cp, ndigits); cp += 2;
+    write_binary_int16(cp, weight); cp += 2;
+    write_binary_int16(cp, sign); cp += 2;
+    write_binary_int16(cp, dscale); cp += 2;
+
+    for (i = 0, digit = 0; i < 4 * ndigits; ++i) {
+        int k = i - offset; /* index in the sequence of decimal digits */
+
+        digit = digit * 10 + (k < 0 || k >= ilen + flen ? 0 :
+            k < ilen ? ip[k] - '0' : fp[k - ilen] - '0');
+        if (i % 4 == 3) {
+            write_binary_int16(cp, digit); cp += 2; digit = 0;
+        }
+    }
+    return 0;
+}
+
+/* Append one value to the copy buffer in the binary wire format of the
+   given column type.  Returns 0 on success, -1 with an exception set
+   otherwise. */
+static int
+_copy_add_value(PyObject *item, Oid type, int encoding,
+                char **buf, size_t *len, size_t *size)
+{
+    char *cp;
+
+    if (item == Py_None) {
+        if (!(cp = _copy_buf_reserve(buf, len, size, 4))) goto memory_error;
+        write_binary_int32(cp, -1);
+        return 0;
+    }
+
+    switch (type) {
+
+        case INT2OID:
+        case INT4OID:
+        case INT8OID:
+        {
+            PyObject *num = PyNumber_Long(item);
+            PY_LONG_LONG v;
+            int dlen = type == INT2OID ? 2 : type == INT4OID ? 4 : 8;
+
+            if (!num) return -1;
+            v = PyLong_AsLongLong(num);
+            Py_DECREF(num);
+            if (v == -1 && PyErr_Occurred()) return -1;
+            if ((dlen == 2 && (v < -0x8000 || v > 0x7fff)) ||
+                (dlen == 4 && (v < -0x7fffffffLL - 1 || v > 0x7fffffffLL)))
+            {
+                PyErr_SetString(PyExc_OverflowError,
+                                "Value out of range for integer column");
+                return -1;
+            }
+            if (!(cp = _copy_buf_reserve(buf, len, size, (size_t) (4 + dlen))))
+                goto memory_error;
+            write_binary_int32(cp, dlen);
+            if (dlen == 2) write_binary_int16(cp + 4, (int) v);
+            else if (dlen == 4) write_binary_int32(cp + 4, (long) v);
+            else write_binary_int64(cp + 4, v);
+            return 0;
+        }
+
+        case FLOAT4OID:
+        {
+            union { float f; int i; } u;
+            double d = PyFloat_AsDouble(item);
+
+            if (d == -1.0 && PyErr_Occurred()) return -1;
+            u.f = (float) d;
+            if (!(cp = _copy_buf_reserve(buf, len, size, 8)))
+                goto memory_error;
+            write_binary_int32(cp, 4);
+            write_binary_int32(cp + 4, (long) u.i);
+            return 0;
+        }
+
+        case FLOAT8OID:
+        {
+            union { double d; PY_LONG_LONG i; } u;
+
+            u.d = PyFloat_AsDouble(item);
+            if (u.d == -1.0 && PyErr_Occurred()) return -1;
+            if (!(cp = _copy_buf_reserve(buf, len, size, 12)))
+                goto memory_error;
+            write_binary_int32(cp, 8);
+            write_binary_int64(cp + 4, u.i);
+            return 0;
+        }
+
+        case NUMERICOID:
+        {
+            PyObject *str_obj = PyObject_Str(item);
+            const char *t;
+            int res;
+
+            if (!str_obj) return -1;
+            t = PyStr_AsString(str_obj);
+            if (t && (strchr(t, 'e') || strchr(t, 'E'))) {
+                /* get rid of exponential notation */
+                PyObject *fmt = PyStr_FromString("f");
+                PyObject *plain = fmt ? PyObject_Format(item, fmt) : NULL;
+
+                Py_XDECREF(fmt); Py_DECREF(str_obj);
+                if (!plain) return -1;
+                str_obj = plain;
+                t = PyStr_AsString(str_obj);
+            }
+            if (!t) {
+                Py_DECREF(str_obj); return -1;
+            }
+            res = _copy_add_numeric(t, buf, len, size);
+            Py_DECREF(str_obj);
+            if (res) goto memory_error;
+            return 0;
+        }
+
+        case BOOLOID:
+        {
+            int v = PyObject_IsTrue(item);
+
+            if (v < 0) return -1;
+            if (!(cp = _copy_buf_reserve(buf, len, size, 5)))
+                goto memory_error;
+            write_binary_int32(cp, 1);
+            cp[4] = (char) v;
+            return 0;
+        }
+
+        case DATEOID:
+        {
+            if (!PyDateTimeAPI) {
+                PyDateTime_IMPORT;
+                if (!PyDateTimeAPI) return -1;
+            }
+            if (!PyDate_Check(item)) {
+                PyErr_SetString(PyExc_TypeError,
+                                "Date columns require date values");
+                return -1;
+            }
+            if (!(cp = _copy_buf_reserve(buf, len, size, 8)))
+                goto memory_error;
+            write_binary_int32(cp, 4);
+            write_binary_int32(cp + 4, _copy_date_days(
+                PyDateTime_GET_YEAR(item), PyDateTime_GET_MONTH(item),
+                PyDateTime_GET_DAY(item)));
+            return 0;
+        }
+
+        case TIMEOID:
+        {
+            PY_LONG_LONG usecs;
+
+            if (!PyDateTimeAPI) {
+                PyDateTime_IMPORT;
+                if (!PyDateTimeAPI) return -1;
+            }
+            if (!PyTime_Check(item)) {
+                PyErr_SetString(PyExc_TypeError,
+                                "Time columns require time values");
+                return -1;
+            }
+            usecs = ((PyDateTime_TIME_GET_HOUR(item) * 60LL +
+                PyDateTime_TIME_GET_MINUTE(item)) * 60 +
+                PyDateTime_TIME_GET_SECOND(item)) * 1000000 +
+                PyDateTime_TIME_GET_MICROSECOND(item);
+            if (!(cp = _copy_buf_reserve(buf, len, size, 12)))
+                goto memory_error;
+            write_binary_int32(cp, 8);
+            write_binary_int64(cp + 4, usecs);
+            return 0;
+        }
+
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+        {
+            PY_LONG_LONG usecs;
+
+            if (!PyDateTimeAPI) {
+                PyDateTime_IMPORT;
+                if (!PyDateTimeAPI) return -1;
+            }
+            if (!PyDateTime_Check(item)) {
+                PyErr_SetString(PyExc_TypeError,
+                                "Timestamp columns require datetime values");
+                return -1;
+            }
+            usecs = _copy_date_days(
+                PyDateTime_GET_YEAR(item), PyDateTime_GET_MONTH(item),
+                PyDateTime_GET_DAY(item)) * 86400000000LL +
+                ((PyDateTime_DATE_GET_HOUR(item) * 60LL +
+                PyDateTime_DATE_GET_MINUTE(item)) * 60 +
+                PyDateTime_DATE_GET_SECOND(item)) * 1000000 +
+                PyDateTime_DATE_GET_MICROSECOND(item);
+            if (type == TIMESTAMPTZOID) {
+                /* binary timestamps with time zone are passed in UTC */
+                PyObject *offset = PyObject_CallMethod(
+                    item, "utcoffset", NULL);
+
+                if (!offset) return -1;
+                if (offset != Py_None) {
+                    usecs -= (PyDateTime_DELTA_GET_DAYS(offset) * 86400LL +
+                        PyDateTime_DELTA_GET_SECONDS(offset)) * 1000000 +
+                        PyDateTime_DELTA_GET_MICROSECONDS(offset);
+                }
+                Py_DECREF(offset);
+            }
+            if (!(cp = _copy_buf_reserve(buf, len, size, 12)))
+                goto memory_error;
+            write_binary_int32(cp, 8);
+            write_binary_int64(cp + 4, usecs);
+            return 0;
+        }
+
+        default: /* BYTEAOID, textual types and everything else */
+        {
+            char *t;
+            Py_ssize_t slen;
+
+            if (PyBytes_Check(item)) {
+                /* pass bytes through, for bytea and textual columns or as
+                   the ready-made wire representation of other types */
+                PyBytes_AsStringAndSize(item, &t, &slen);
+                if (!(cp = _copy_buf_reserve(
+                    buf, len, size, 4 + (size_t) slen)))
+                {
+                    goto memory_error;
+                }
+                write_binary_int32(cp, (long) slen);
+                memcpy(cp + 4, t, (size_t) slen);
+            }
+            else if (PyUnicode_Check(item)) {
+                PyObject *s = get_encoded_string(item, encoding);
+
+                if (!s) return -1; /* pass the UnicodeEncodeError */
+                PyBytes_AsStringAndSize(s, &t, &slen);
+                if (!(cp = _copy_buf_reserve(
+                    buf, len, size, 4 + (size_t) slen)))
+                {
+                    Py_DECREF(s); goto memory_error;
+                }
+                write_binary_int32(cp, (long) slen);
+                memcpy(cp + 4, t, (size_t) slen);
+                Py_DECREF(s);
+            }
+            else {
+                PyErr_SetString(
+                    PyExc_TypeError,
+                    "This column type requires str or bytes values"
+                    " for a binary copy");
+                return -1;
+            }
+            return 0;
+        }
+    }
+
+memory_error:
+    PyErr_NoMemory();
+    return -1;
+}
+
+/* Insert an iterable of rows into a table using binary COPY. */
+static char conn_inserttable_binary__doc__[] =
+"inserttable_binary(table, data, [columns], [chunk_size]) -- bulk insert\n\n"
+"Works like inserttable(), but encodes the values directly in the\n"
+"binary COPY wire format and streams them to the server in chunks of\n"
+"the given size.  The data can be any iterable yielding rows, so the\n"
+"full row list never needs to be materialized in memory.\n";
+
+static PyObject *
+conn_inserttable_binary(connObject *self, PyObject *args)
+{
+    PGresult *result;
+    char *table, *buffer, *bufpt, *cp;
+    int encoding, num_fields, rc;
+    size_t bufsiz, buflen = 0;
+    long chunk_size = MAX_BUFFER_SIZE;
+    Oid *types;
+    PyObject *data, *iter, *row, *columns = NULL;
+    PyObject *(*getcolumn) (PyObject *, Py_ssize_t);
+    Py_ssize_t j, n = 0;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "sO|Ol", &table, &data, &columns,
+                          &chunk_size))
+    {
+        PyErr_SetString(
+            PyExc_TypeError,
+            "Method inserttable_binary() expects a string and an iterable"
+            " as arguments");
+        return NULL;
+    }
+    if (chunk_size < 1) {
+        PyErr_SetString(PyExc_ValueError, "Chunk size must be positive");
+        return NULL;
+    }
+
+    /* checks columns type */
+    if (columns) {
+        if (PyList_Check(columns)) {
+            n = PyList_Size(columns);
+            getcolumn = PyList_GetItem;
+        }
+        else if (PyTuple_Check(columns)) {
+            n = PyTuple_Size(columns);
+            getcolumn = PyTuple_GetItem;
+        }
+        else {
+            PyErr_SetString(
+                PyExc_TypeError,
+                "Method inserttable_binary() expects a list or a tuple"
+                " as third argument");
+            return NULL;
+        }
+        if (!n) {
+            /* no columns specified, nothing to do */
+            Py_INCREF(Py_None);
+            return Py_None;
+        }
+    }
+
+    if (!(iter = PyObject_GetIter(data))) {
+        PyErr_SetString(
+            PyExc_TypeError,
+            "Method inserttable_binary() expects an iterable"
+            " as second argument");
+        return NULL;
+    }
+
+    /* allocate buffer */
+    bufsiz = MAX_BUFFER_SIZE;
+    if (!(buffer = PyMem_Malloc(bufsiz))) {
+        Py_DECREF(iter);
+        return PyErr_NoMemory();
+    }
+
+    encoding = PQclientEncoding(self->cnx);
+
+    /* starts query */
+    bufpt = buffer;
+    table = PQescapeIdentifier(self->cnx, table, strlen(table));
+    bufpt += sprintf(bufpt, "copy %s", table);
+    PQfreemem(table);
+    if (columns) {
+        /* adds a string like f" ({','.join(columns)})" */
+        bufpt += sprintf(bufpt, " (");
+        for (j = 0; j < n; ++j) {
+            PyObject *obj = getcolumn(columns, j);
+            ssize_t slen;
+            char *col;
+
+            if (PyBytes_Check(obj)) {
+                PyBytes_AsStringAndSize(obj, &col, &slen);
+            }
+            else if (PyUnicode_Check(obj)) {
+                obj = get_encoded_string(obj, encoding);
+                if (!obj) {
+                    PyMem_Free(buffer); Py_DECREF(iter);
                     return NULL; /* pass the UnicodeEncodeError */
                 }
-                else {
-                    const char* t = PyBytes_AsString(s);
-
-                    while (*t && bufsiz) {
-                        if (*t == '\\' || *t == '\t' || *t == '\n') {
-                            *bufpt++ = '\\'; --bufsiz;
-                            if (!bufsiz) break;
-                        }
-                        *bufpt++ = *t++; --bufsiz;
-                    }
-                    Py_DECREF(s);
-                }
+                PyBytes_AsStringAndSize(obj, &col, &slen);
+                Py_DECREF(obj);
+            } else {
+                PyMem_Free(buffer); Py_DECREF(iter);
+                PyErr_SetString(
+                    PyExc_TypeError,
+                    "The third argument must contain only strings");
+                return NULL;
             }
-            else if (PyInt_Check(item) || PyLong_Check(item)) {
-                PyObject* s = PyObject_Str(item);
-                const char* t = PyStr_AsString(s);
+            col = PQescapeIdentifier(self->cnx, col, (size_t) slen);
+            bufpt += sprintf(bufpt, "%s%s", col, j == n - 1 ? ")" : ",");
+            PQfreemem(col);
+        }
+    }
+    sprintf(bufpt, " from stdin (format binary)");
 
-                while (*t && bufsiz) {
-                    *bufpt++ = *t++; --bufsiz;
-                }
-                Py_DECREF(s);
-            }
-            else {
-                PyObject* s = PyObject_Repr(item);
-                const char* t = PyStr_AsString(s);
+    Py_BEGIN_ALLOW_THREADS
+    result = PQexec(self->cnx, buffer);
+    Py_END_ALLOW_THREADS
 
-                while (*t && bufsiz) {
-                    if (*t == '\\' || *t == '\t' || *t == '\n') {
-                        *bufpt++ = '\\'; --bufsiz;
-                        if (!bufsiz) break;
-                    }
-                    *bufpt++ = *t++; --bufsiz;
-                }
-                Py_DECREF(s);
-            }
+    if (!result || PQresultStatus(result) != PGRES_COPY_IN) {
+        set_error(ProgrammingError, "Cannot start binary copy",
+                  self->cnx, result);
+        if (result) PQclear(result);
+        PyMem_Free(buffer); Py_DECREF(iter);
+        return NULL;
+    }
 
-            if (bufsiz <= 0) {
-                PyMem_Free(buffer); return PyErr_NoMemory();
-            }
+    /* memorize the column types of the copy target */
+    num_fields = PQnfields(result);
+    if (!(types = (Oid *) PyMem_Malloc(
+        (size_t) num_fields * sizeof(Oid))))
+    {
+        PQclear(result);
+        PyMem_Free(buffer); Py_DECREF(iter);
+        return PyErr_NoMemory();
+    }
+    for (j = 0; j < num_fields; ++j) {
+        types[j] = PQftype(result, (int) j);
+    }
+    PQclear(result);
 
-        }
+    /* writes the header of the binary copy format */
+    cp = _copy_buf_reserve(&buffer, &buflen, &bufsiz, 19);
+    memcpy(cp, "PGCOPY\n\377\r\n\0", 11);
+    write_binary_int32(cp + 11, 0); /* flags */
+    write_binary_int32(cp + 15, 0); /* extension length */
 
-        *bufpt++ = '\n'; *bufpt = '\0';
+    /* feed table */
+    while ((row = PyIter_Next(iter))) {
+        PyObject *fast = PySequence_Fast(
+            row, "The rows must be given as sequences");
+
+        Py_DECREF(row);
+        if (!fast) goto copy_error;
+        if (PySequence_Fast_GET_SIZE(fast) != num_fields) {
+            Py_DECREF(fast);
+            PyErr_SetString(
+                PyExc_TypeError,
+                "The rows must have the same size as the copied columns");
+            goto copy_error;
+        }
 
-        /* sends data */
-        if (PQputline(self->cnx, buffer)) {
-            PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
-            PQendcopy(self->cnx);
-            PyMem_Free(buffer);
-            return NULL;
+        if (!(cp = _copy_buf_reserve(&buffer, &buflen, &bufsiz, 2))) {
+            Py_DECREF(fast); PyErr_NoMemory();
+            goto copy_error;
+        }
+        write_binary_int16(cp, num_fields);
+
+        for (j = 0; j < num_fields; ++j) {
+            if (_copy_add_value(
+                PySequence_Fast_GET_ITEM(fast, j), types[j],
+                encoding, &buffer, &buflen, &bufsiz))
+            {
+                Py_DECREF(fast);
+                goto copy_error;
+            }
+        }
+        Py_DECREF(fast);
+        ++self->stats.rows;
+
+        if (buflen >= (size_t) chunk_size) { /* sends one chunk of rows */
+            Py_BEGIN_ALLOW_THREADS
+            rc = PQputCopyData(self->cnx, buffer, (int) buflen);
+            Py_END_ALLOW_THREADS
+            if (rc != 1) {
+                PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
+                goto copy_error;
+            }
+            self->stats.bytes += (unsigned PY_LONG_LONG) buflen;
+            buflen = 0;
         }
     }
+    if (PyErr_Occurred()) goto copy_error; /* error in the iterator */
 
-    /* ends query */
-    if (PQputline(self->cnx, "\\.\n")) {
-        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
-        PQendcopy(self->cnx);
-        PyMem_Free(buffer);
-        return NULL;
+    /* writes the trailer and sends the remaining data */
+    if (!(cp = _copy_buf_reserve(&buffer, &buflen, &bufsiz, 2))) {
+        PyErr_NoMemory();
+        goto copy_error;
     }
+    write_binary_int16(cp, -1);
 
-    if (PQendcopy(self->cnx)) {
+    Py_BEGIN_ALLOW_THREADS
+    rc = PQputCopyData(self->cnx, buffer, (int) buflen);
+    if (rc == 1) {
+        rc = PQputCopyEnd(self->cnx, NULL);
+    }
+    Py_END_ALLOW_THREADS
+    if (rc != 1) {
         PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
-        PyMem_Free(buffer);
-        return NULL;
+        goto copy_done;
     }
+    self->stats.bytes += (unsigned PY_LONG_LONG) buflen;
 
-    PyMem_Free(buffer);
+    /* checks the result of the copy operation */
+    Py_BEGIN_ALLOW_THREADS
+    result = PQgetResult(self->cnx);
+    Py_END_ALLOW_THREADS
+    if (!result || PQresultStatus(result) != PGRES_COMMAND_OK) {
+        set_error(ProgrammingError, "Error in binary copy",
+                  self->cnx, result);
+        if (result) PQclear(result);
+        goto copy_done;
+    }
+    PQclear(result);
+    while ((result = PQgetResult(self->cnx))) {
+        PQclear(result);
+    }
+
+    PyMem_Free(types); PyMem_Free(buffer); Py_DECREF(iter);
 
     /* no error : returns nothing */
     Py_INCREF(Py_None);
     return Py_None;
+
+copy_error:
+    /* aborts the copy operation so the connection remains usable */
+    PQputCopyEnd(self->cnx, "error while encoding the data");
+copy_done:
+    while ((result = PQgetResult(self->cnx))) {
+        PQclear(result);
+    }
+    PyMem_Free(types); PyMem_Free(buffer); Py_DECREF(iter);
+    return NULL;
 }
 
 /* Get transaction state. */
@@ -960,6 +2535,81 @@ conn_transaction(connObject *self, PyObject *noargs)
     return PyInt_FromLong(PQtransactionStatus(self->cnx));
 }
 
+/* Get performance statistics. */
+static char conn_stats__doc__[] =
+"stats() -- return the performance counters of the connection";
+
+static PyObject *
+conn_stats(connObject *self, PyObject *noargs)
+{
+    connStats *stats = &self->stats;
+
+    return Py_BuildValue("{s:k, s:k, s:K, s:d, s:d, s:k, s:k}",
+        "queries", stats->queries,
+        "rows", stats->rows,
+        "bytes", stats->bytes,
+        "server_time", stats->server_time,
+        "cast_time", stats->cast_time,
+        "cache_hits", stats->cache_hits,
+        "cache_misses", stats->cache_misses);
+}
+
+/* Enable or disable query capture mode. */
+static char conn_capture_queries__doc__[] =
+"capture_queries(on, [threshold], [hook]) -- set the query capture mode\n\n"
+"When enabled, the wall time spent waiting for the server and the number\n"
+"of affected rows are recorded on every query object returned by this\n"
+"connection, accessible as its 'elapsed' and 'rows_affected' attributes.\n"
+"If a 'hook' callable is passed, statements that took at least\n"
+"'threshold' seconds are additionally explained on the server, and the\n"
+"hook is called with the statement, the elapsed time and the plan in\n"
+"JSON format. Capturing is disabled again by passing a false value.\n";
+
+static PyObject *
+conn_capture_queries(connObject *self, PyObject *args)
+{
+    int on;
+    double threshold = 0;
+    PyObject *hook = NULL;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "i|dO", &on, &threshold, &hook)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method capture_queries() expects a flag and an"
+                        " optional threshold and hook as arguments");
+        return NULL;
+    }
+
+    if (hook == Py_None) hook = NULL;
+    if (hook && !PyCallable_Check(hook)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "The hook passed to capture_queries()"
+                        " must be callable or None");
+        return NULL;
+    }
+    if (threshold < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Threshold must not be negative");
+        return NULL;
+    }
+
+    if (!on) {
+        threshold = 0;
+        hook = NULL;
+    }
+    self->query_capture = on ? 1 : 0;
+    self->explain_threshold = threshold;
+    Py_XINCREF(hook); Py_XDECREF(self->explain_hook);
+    self->explain_hook = hook;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 /* Get parameter setting. */
 static char conn_parameter__doc__[] =
 "parameter(name) -- look up a current parameter setting";
@@ -1220,6 +2870,7 @@ large_new(connObject *pgcnx, Oid oid)
     large_obj->pgcnx = pgcnx;
     large_obj->lo_fd = -1;
     large_obj->lo_oid = oid;
+    large_obj->chunk_size = COPY_BUFFER_SIZE;
 
     return large_obj;
 }
@@ -1336,6 +2987,9 @@ conn_reset(connObject *self, PyObject *noargs)
         return NULL;
     }
 
+    /* the server-side prepared statements do not survive the reset */
+    _conn_stmt_cache_clear(self);
+
     /* resets the connection */
     PQreset(self->cnx);
     Py_INCREF(Py_None);
@@ -1489,6 +3143,111 @@ conn_get_notice_receiver(connObject *self, PyObject *noargs)
     return ret;
 }
 
+/* Collect server notices in a bounded ring buffer. */
+static char conn_collect_notices__doc__[] =
+"collect_notices(size, [severity]) -- collect notices in a ring buffer\n\n"
+"Up to 'size' server notices are collected in a fixed C buffer without\n"
+"creating any Python objects; when the buffer is full, the oldest notice\n"
+"is dropped. Notices below the optional minimum 'severity' (one of\n"
+"'DEBUG', 'LOG', 'INFO', 'NOTICE', 'WARNING' or 'ERROR') are discarded\n"
+"at the C level. A size of 0 stops collecting and frees the buffer.\n"
+"The collected notices can be retrieved with the notices() method.\n";
+
+static PyObject *
+conn_collect_notices(connObject *self, PyObject *args)
+{
+    int size, level = 0;
+    const char *severity = NULL;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "i|s", &size, &severity)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method collect_notices() expects a buffer size"
+                        " and an optional severity as arguments");
+        return NULL;
+    }
+
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Buffer size must not be negative");
+        return NULL;
+    }
+
+    if (severity) {
+        level = _notice_severity(severity);
+        if (!level) {
+            PyErr_SetString(PyExc_ValueError, "Unknown severity");
+            return NULL;
+        }
+    }
+
+    _conn_notice_ring_clear(self);
+
+    if (size) {
+        /* allocated with malloc since the notice receiver callback
+           appends entries without holding the GIL */
+        char **ring = calloc((size_t) size, sizeof(char *));
+        if (!ring) {
+            return PyErr_NoMemory();
+        }
+        self->notice_ring = ring;
+        self->notice_size = size;
+        self->notice_level = level;
+        PQsetNoticeReceiver(self->cnx, notice_receiver, self);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Get and remove collected notices. */
+static char conn_notices__doc__[] =
+"notices([max]) -- get and remove collected notices\n\n"
+"Return a list with at most 'max' of the oldest collected notices as\n"
+"(severity, message) tuples, removing them from the ring buffer.\n"
+"Without argument, all collected notices are returned.\n";
+
+static PyObject *
+conn_notices(connObject *self, PyObject *args)
+{
+    int i, num = -1;
+    PyObject *ret;
+
+    if (!PyArg_ParseTuple(args, "|i", &num)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method notices() expects an optional maximum"
+                        " number as argument");
+        return NULL;
+    }
+
+    if (num < 0 || num > self->notice_count)
+        num = self->notice_count;
+
+    ret = PyList_New(num);
+    if (!ret) return NULL;
+
+    for (i = 0; i < num; ++i) {
+        char *entry = self->notice_ring[self->notice_head];
+        PyObject *pair = Py_BuildValue(
+            "(ss)", entry, entry + strlen(entry) + 1);
+        if (!pair) {
+            Py_DECREF(ret);
+            return NULL;
+        }
+        PyList_SET_ITEM(ret, i, pair);
+        free(entry);
+        self->notice_ring[self->notice_head] = NULL;
+        self->notice_head = (self->notice_head + 1) % self->notice_size;
+        --self->notice_count;
+    }
+
+    return ret;
+}
+
 /* Close without deleting. */
 static char conn_close__doc__[] =
 "close() -- close connection\n\n"
@@ -1504,6 +3263,8 @@ conn_close(connObject *self, PyObject *noargs)
         return NULL;
     }
 
+    _conn_stmt_cache_clear(self);
+
     Py_BEGIN_ALLOW_THREADS
     PQfinish(self->cnx);
     Py_END_ALLOW_THREADS
@@ -1513,6 +3274,41 @@ conn_close(connObject *self, PyObject *noargs)
     return Py_None;
 }
 
+/* Build a (relname, pid, extra) tuple from a notification. */
+static PyObject *
+_notify_to_tuple(PGnotify *notify)
+{
+    PyObject *notify_result, *tmp;
+
+    if (!(tmp = PyStr_FromString(notify->relname))) {
+        return NULL;
+    }
+
+    if (!(notify_result = PyTuple_New(3))) {
+        Py_DECREF(tmp);
+        return NULL;
+    }
+
+    PyTuple_SET_ITEM(notify_result, 0, tmp);
+
+    if (!(tmp = PyInt_FromLong(notify->be_pid))) {
+        Py_DECREF(notify_result);
+        return NULL;
+    }
+
+    PyTuple_SET_ITEM(notify_result, 1, tmp);
+
+    /* extra exists even in old versions that did not support it */
+    if (!(tmp = PyStr_FromString(notify->extra))) {
+        Py_DECREF(notify_result);
+        return NULL;
+    }
+
+    PyTuple_SET_ITEM(notify_result, 2, tmp);
+
+    return notify_result;
+}
+
 /* Get asynchronous notify. */
 static char conn_get_notify__doc__[] =
 "getnotify() -- get database notify for this connection";
@@ -1521,6 +3317,7 @@ static PyObject *
 conn_get_notify(connObject *self, PyObject *noargs)
 {
     PGnotify *notify;
+    PyObject *notify_result;
 
     if (!self->cnx) {
         PyErr_SetString(PyExc_TypeError, "Connection is not valid");
@@ -1534,38 +3331,128 @@ conn_get_notify(connObject *self, PyObject *noargs)
         Py_INCREF(Py_None);
         return Py_None;
     }
-    else {
-        PyObject *notify_result, *tmp;
 
-        if (!(tmp = PyStr_FromString(notify->relname))) {
+    notify_result = _notify_to_tuple(notify);
+    PQfreemem(notify);
+    return notify_result;
+}
+
+/* Wait for asynchronous notifications. */
+static char conn_wait_notify__doc__[] =
+"wait_notify(timeout) -- wait for notifies and return them as a batch";
+
+static PyObject *
+conn_wait_notify(connObject *self, PyObject *args)
+{
+    PyObject *timeout_obj = Py_None, *notify_list;
+    PGnotify *notify;
+    double timeout = -1.0;
+    int sock;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "|O", &timeout_obj)) {
+        return NULL;
+    }
+    if (timeout_obj != Py_None) {
+        timeout = PyFloat_AsDouble(timeout_obj);
+        if (PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "Method wait_notify() expects"
+                            " a number or None as argument");
             return NULL;
         }
-
-        if (!(notify_result = PyTuple_New(3))) {
+        if (timeout < 0) {
+            PyErr_SetString(PyExc_ValueError,
+                            "Method wait_notify() expects"
+                            " a non-negative timeout");
             return NULL;
         }
+    }
 
-        PyTuple_SET_ITEM(notify_result, 0, tmp);
+    if ((sock = PQsocket(self->cnx)) < 0) {
+        PyErr_SetString(PyExc_IOError, "Connection socket is not valid");
+        return NULL;
+    }
 
-        if (!(tmp = PyInt_FromLong(notify->be_pid))) {
-            Py_DECREF(notify_result);
-            return NULL;
-        }
+    if (!(notify_list = PyList_New(0))) {
+        return NULL;
+    }
 
-        PyTuple_SET_ITEM(notify_result, 1, tmp);
+    for (;;) {
+        int ready;
 
-        /* extra exists even in old versions that did not support it */
-        if (!(tmp = PyStr_FromString(notify->extra))) {
-            Py_DECREF(notify_result);
+        /* drain all notifications that are already buffered */
+        if (!PQconsumeInput(self->cnx)) {
+            Py_DECREF(notify_list);
+            PyErr_SetString(PyExc_IOError, PQerrorMessage(self->cnx));
             return NULL;
         }
+        while ((notify = PQnotifies(self->cnx))) {
+            PyObject *notify_result = _notify_to_tuple(notify);
+
+            PQfreemem(notify);
+            if (!notify_result
+                || PyList_Append(notify_list, notify_result))
+            {
+                Py_XDECREF(notify_result); Py_DECREF(notify_list);
+                return NULL;
+            }
+            Py_DECREF(notify_result);
+        }
+        if (PyList_GET_SIZE(notify_list) > 0) {
+            break; /* return everything that arrived in one batch */
+        }
 
-        PyTuple_SET_ITEM(notify_result, 2, tmp);
+        /* block on the connection socket with the GIL released */
+        Py_BEGIN_ALLOW_THREADS
+#ifdef HAVE_POLL
+        {
+            struct pollfd pfd;
 
-        PQfreemem(notify);
+            pfd.fd = sock; pfd.events = POLLIN; pfd.revents = 0;
+            ready = poll(&pfd, 1,
+                         timeout < 0 ? -1 : (int) (timeout * 1000.0));
+        }
+#else
+        {
+            fd_set rfds;
+            struct timeval tv, *tvp = NULL;
+
+            FD_ZERO(&rfds); FD_SET(sock, &rfds);
+            if (timeout >= 0) {
+                tv.tv_sec = (long) timeout;
+                tv.tv_usec = (long) ((timeout - (double) tv.tv_sec) * 1e6);
+                tvp = &tv;
+            }
+            ready = select(sock + 1, &rfds, NULL, NULL, tvp);
+        }
+#endif
+        Py_END_ALLOW_THREADS
 
-        return notify_result;
+        if (ready < 0) {
+            if (errno == EINTR) {
+                /* pass KeyboardInterrupt etc. on to the caller */
+                if (PyErr_CheckSignals()) {
+                    Py_DECREF(notify_list);
+                    return NULL;
+                }
+                continue;
+            }
+            Py_DECREF(notify_list);
+            PyErr_SetFromErrno(PyExc_IOError);
+            return NULL;
+        }
+        if (ready == 0) {
+            break; /* timed out, return the empty list */
+        }
     }
+
+    return notify_list;
 }
 
 /* Get the list of connection attributes. */
@@ -1584,6 +3471,17 @@ conn_dir(connObject *self, PyObject *noargs)
     return attrs;
 }
 
+/* The copyto and copyfrom methods are defined in pgsource.c, where
+   they share the copy helpers of the source object, but they are
+   listed here. */
+static PyObject *conn_copyto(connObject *, PyObject *);
+static char conn_copyto__doc__[] =
+"copyto(command, file) -- copy a table or query directly to a file";
+
+static PyObject *conn_copyfrom(connObject *, PyObject *);
+static char conn_copyfrom__doc__[] =
+"copyfrom(command, data, [buffer_size]) -- copy directly from a data source";
+
 /* Connection object methods */
 static struct PyMethodDef conn_methods[] = {
     {"__dir__", (PyCFunction) conn_dir,  METH_NOARGS, NULL},
@@ -1592,14 +3490,34 @@ static struct PyMethodDef conn_methods[] = {
         METH_NOARGS, conn_source__doc__},
     {"query", (PyCFunction) conn_query,
         METH_VARARGS, conn_query__doc__},
+    {"query_binary", (PyCFunction) conn_query_binary,
+        METH_VARARGS, conn_query_binary__doc__},
+    {"query_streaming", (PyCFunction) conn_query_streaming,
+        METH_VARARGS, conn_query_streaming__doc__},
     {"send_query", (PyCFunction) conn_send_query,
         METH_VARARGS, conn_send_query__doc__},
+#if IS_PY3
+    {"query_async", (PyCFunction) conn_query_async,
+        METH_VARARGS, conn_query_async__doc__},
+#endif
     {"query_prepared", (PyCFunction) conn_query_prepared,
         METH_VARARGS, conn_query_prepared__doc__},
+    {"executemany", (PyCFunction) conn_executemany,
+        METH_VARARGS, conn_executemany__doc__},
     {"prepare", (PyCFunction) conn_prepare,
         METH_VARARGS, conn_prepare__doc__},
     {"describe_prepared", (PyCFunction) conn_describe_prepared,
         METH_VARARGS, conn_describe_prepared__doc__},
+#ifdef PIPELINE_MODE
+    {"enter_pipeline_mode", (PyCFunction) conn_enter_pipeline_mode,
+        METH_NOARGS, conn_enter_pipeline_mode__doc__},
+    {"exit_pipeline_mode", (PyCFunction) conn_exit_pipeline_mode,
+        METH_NOARGS, conn_exit_pipeline_mode__doc__},
+    {"pipeline_sync", (PyCFunction) conn_pipeline_sync,
+        METH_NOARGS, conn_pipeline_sync__doc__},
+    {"pipeline_status", (PyCFunction) conn_pipeline_status,
+        METH_NOARGS, conn_pipeline_status__doc__},
+#endif /* PIPELINE_MODE */
     {"poll", (PyCFunction) conn_poll,
         METH_NOARGS, conn_poll__doc__},
     {"reset", (PyCFunction) conn_reset,
@@ -1610,6 +3528,10 @@ static struct PyMethodDef conn_methods[] = {
         METH_NOARGS, conn_close__doc__},
     {"fileno", (PyCFunction) conn_fileno,
         METH_NOARGS, conn_fileno__doc__},
+    {"get_statement_cache_size", (PyCFunction) conn_get_statement_cache_size,
+        METH_NOARGS, conn_get_statement_cache_size__doc__},
+    {"set_statement_cache_size", (PyCFunction) conn_set_statement_cache_size,
+        METH_VARARGS, conn_set_statement_cache_size__doc__},
     {"get_cast_hook", (PyCFunction) conn_get_cast_hook,
         METH_NOARGS, conn_get_cast_hook__doc__},
     {"set_cast_hook", (PyCFunction) conn_set_cast_hook,
@@ -1618,12 +3540,28 @@ static struct PyMethodDef conn_methods[] = {
         METH_NOARGS, conn_get_notice_receiver__doc__},
     {"set_notice_receiver", (PyCFunction) conn_set_notice_receiver,
         METH_O, conn_set_notice_receiver__doc__},
+    {"collect_notices", (PyCFunction) conn_collect_notices,
+        METH_VARARGS, conn_collect_notices__doc__},
+    {"notices", (PyCFunction) conn_notices,
+        METH_VARARGS, conn_notices__doc__},
     {"getnotify", (PyCFunction) conn_get_notify,
         METH_NOARGS, conn_get_notify__doc__},
+    {"wait_notify", (PyCFunction) conn_wait_notify,
+        METH_VARARGS, conn_wait_notify__doc__},
+    {"copyfrom", (PyCFunction) conn_copyfrom,
+        METH_VARARGS, conn_copyfrom__doc__},
+    {"copyto", (PyCFunction) conn_copyto,
+        METH_VARARGS, conn_copyto__doc__},
     {"inserttable", (PyCFunction) conn_inserttable,
         METH_VARARGS, conn_inserttable__doc__},
+    {"inserttable_binary", (PyCFunction) conn_inserttable_binary,
+        METH_VARARGS, conn_inserttable_binary__doc__},
     {"transaction", (PyCFunction) conn_transaction,
         METH_NOARGS, conn_transaction__doc__},
+    {"stats", (PyCFunction) conn_stats,
+        METH_NOARGS, conn_stats__doc__},
+    {"capture_queries", (PyCFunction) conn_capture_queries,
+        METH_VARARGS, conn_capture_queries__doc__},
     {"parameter", (PyCFunction) conn_parameter,
         METH_VARARGS, conn_parameter__doc__},
     {"date_format", (PyCFunction) conn_date_format,
@@ -127,7 +127,6 @@ except ImportError:  # Python < 3.3
     from collections import Iterable
 from collections import namedtuple
 from functools import partial
-from re import compile as regex
 from json import loads as jsondecode, dumps as jsonencode
 
 Decimal = StdDecimal
@@ -251,17 +250,38 @@ shortcutmethods = 1
 
 # *** Internal Type Handling ***
 
-try:    # noinspection PyUnresolvedReferences
-    from inspect import signature
-except ImportError:  # Python < 3.3
-    from inspect import getargspec
+def get_args(func):
+    """Get the arguments of the given function.
 
-    def get_args(func):
+    The inspect module is fairly expensive to import, so it is only
+    imported here when a typecast function is actually inspected,
+    instead of slowing down every import of this module.
+    """
+    try:  # noinspection PyUnresolvedReferences
+        from inspect import signature
+    except ImportError:  # Python < 3.3
+        from inspect import getargspec
         return getargspec(func).args
-else:
+    return list(signature(func).parameters)
+
+
+class _LazyRegex(object):
+    """Regular expression that is only compiled when first used.
+
+    Compiling all regular expressions up front takes a considerable
+    part of the module import time, which matters for short-lived
+    processes, so the compilation is deferred until a pattern is
+    actually used.
+    """
+
+    def __init__(self, pattern):
+        self._pattern = pattern
 
-    def get_args(func):
-        return list(signature(func).parameters)
+    def __getattr__(self, name):
+        from re import compile as regex
+        value = getattr(regex(self._pattern), name)
+        setattr(self, name, value)  # cache for subsequent uses
+        return value
 
 try:
     from datetime import timezone
@@ -376,7 +396,7 @@ def cast_time(value):
     return datetime.strptime(value, fmt).time()
 
 
-_re_timezone = regex('(.*)([+-].*)')
+_re_timezone = _LazyRegex('(.*)([+-].*)')
 
 
 def cast_timetz(value):
@@ -455,18 +475,18 @@ def cast_timestamptz(value, connection):
         tzinfo=_get_timezone(tz))
 
 
-_re_interval_sql_standard = regex(
+_re_interval_sql_standard = _LazyRegex(
     '(?:([+-])?([0-9]+)-([0-9]+) ?)?'
     '(?:([+-]?[0-9]+)(?!:) ?)?'
     '(?:([+-])?([0-9]+):([0-9]+):([0-9]+)(?:\\.([0-9]+))?)?')
 
-_re_interval_postgres = regex(
+_re_interval_postgres = _LazyRegex(
     '(?:([+-]?[0-9]+) ?years? ?)?'
     '(?:([+-]?[0-9]+) ?mons? ?)?'
     '(?:([+-]?[0-9]+) ?days? ?)?'
     '(?:([+-])?([0-9]+):([0-9]+):([0-9]+)(?:\\.([0-9]+))?)?')
 
-_re_interval_postgres_verbose = regex(
+_re_interval_postgres_verbose = _LazyRegex(
     '@ ?(?:([+-]?[0-9]+) ?years? ?)?'
     '(?:([+-]?[0-9]+) ?mons? ?)?'
     '(?:([+-]?[0-9]+) ?days? ?)?'
@@ -474,7 +494,7 @@ _re_interval_postgres_verbose = regex(
     '(?:([+-]?[0-9]+) ?mins? ?)?'
     '(?:([+-])?([0-9]+)(?:\\.([0-9]+))? ?secs?)? ?(ago)?')
 
-_re_interval_iso_8601 = regex(
+_re_interval_iso_8601 = _LazyRegex(
     'P(?:([+-]?[0-9]+)Y)?'
     '(?:([+-]?[0-9]+)M)?'
     '(?:([+-]?[0-9]+)D)?'
@@ -673,6 +693,12 @@ class Typecasts(dict):
 
 _typecasts = Typecasts()  # this is the global typecast dictionary
 
+# Default typecast functions that the C extension can apply natively
+# based on the column OID, without calling back into Python for every
+# value.  Only casts whose conversion does not depend on any settings
+# are listed here, so native casting is always equivalent.
+_native_typecasts = frozenset([int, long, float, cast_bool, unescape_bytea])
+
 
 def get_typecast(typ):
     """Get the global typecast function for the given database type(s)."""
@@ -773,6 +799,12 @@ class TypeCache(dict):
         super(TypeCache, self).__init__()
         self._escape_string = cnx.escape_string
         self._src = cnx.source()
+        # type info is kept in a process-wide cache shared between all
+        # connections to the same database, so reconnecting does not
+        # query the catalogs again for already discovered types
+        self._shared = get_shared_cache('%s:%s/%s@%s' % (
+            cnx.host or 'localhost', cnx.port, cnx.db,
+            cnx.user)).setdefault('pg_type', {})
         self._typecasts = LocalTypecasts()
         self._typecasts.get_fields = self.get_fields
         self._typecasts.connection = cnx
@@ -790,24 +822,30 @@ class TypeCache(dict):
 
     def __missing__(self, key):
         """Get the type info from the database if it is not cached."""
-        if isinstance(key, int):
-            oid = key
-        else:
-            if '.' not in key and '"' not in key:
-                key = '"%s"' % (key,)
-            oid = "'%s'::regtype" % (self._escape_string(key),)
-        try:
-            self._src.execute(self._query_pg_type % (oid,))
-        except ProgrammingError:
-            res = None
-        else:
-            res = self._src.fetch(1)
-        if not res:
-            raise KeyError('Type %s could not be found' % (key,))
-        res = res[0]
-        type_code = TypeCode.create(
-            int(res[0]), res[1], int(res[2]),
-            res[3], res[4], res[5], int(res[6]))
+        try:  # check the shared process-wide cache first
+            type_code = self._shared[key]
+        except KeyError:
+            if isinstance(key, int):
+                oid = key
+            else:
+                if '.' not in key and '"' not in key:
+                    key = '"%s"' % (key,)
+                oid = "'%s'::regtype" % (self._escape_string(key),)
+            try:
+                self._src.execute(self._query_pg_type % (oid,))
+            except ProgrammingError:
+                res = None
+            else:
+                res = self._src.fetch(1)
+            if not res:
+                raise KeyError('Type %s could not be found' % (key,))
+            res = res[0]
+            type_code = TypeCode.create(
+                int(res[0]), res[1], int(res[2]),
+                res[3], res[4], res[5], int(res[6]))
+            # noinspection PyUnresolvedReferences
+            self._shared[type_code.oid] = \
+                self._shared[str(type_code)] = type_code
         # noinspection PyUnresolvedReferences
         self[type_code.oid] = self[str(type_code)] = type_code
         return type_code
@@ -859,6 +897,18 @@ class TypeCache(dict):
             return value
         return cast(value)
 
+    def get_row_casts(self, types):
+        """Get the list of typecast functions for a row of the given types.
+
+        Types that do not need to be cast are represented by None, and
+        types whose default cast is applied natively in the C extension
+        based on the column OID are represented by True.
+        """
+        typecasts = self._typecasts
+        casts = [typecasts[typ] for typ in types]
+        return [None if cast is str else True if cast in _native_typecasts
+                else cast for cast in casts]
+
     def get_row_caster(self, types):
         """Get a typecast function for a complete row of values."""
         typecasts = self._typecasts
@@ -901,7 +951,7 @@ def _op_error(msg):
 # *** Row Tuples ***
 
 
-_re_fieldname = regex('^[A-Za-z][_a-zA-Z0-9]*$')
+_re_fieldname = _LazyRegex('^[A-Za-z][_a-zA-Z0-9]*$')
 
 
 # The result rows for database operations are returned as named tuples
@@ -1184,21 +1234,17 @@ class Cursor(object):
         if keep:
             self.arraysize = size
         try:
-            result = self._src.fetch(size)
+            # look up all type casting functions upfront and apply them
+            # in C while the rows are being built, instead of casting
+            # every single value from Python afterwards
+            casts = self.type_cache.get_row_casts(self.coltypes)
+            result = self._src.fetch_typed(casts, size)
         except DatabaseError:
             raise
         except Error as err:
             raise _db_error(str(err))
         row_factory = self.row_factory
-        coltypes = self.coltypes
-        if len(result) > 5:
-            # optimize the case where we really fetch many values
-            # by looking up all type casting functions upfront
-            cast_row = self.type_cache.get_row_caster(coltypes)
-            return [row_factory(cast_row(row)) for row in result]
-        cast_value = self.type_cache.typecast
-        return [row_factory([cast_value(value, typ)
-                for typ, value in zip(coltypes, row)]) for row in result]
+        return [row_factory(row) for row in result]
 
     def callproc(self, procname, parameters=None):
         """Call a stored database procedure with the given name.
@@ -1885,8 +1931,8 @@ Uuid = Uuid  # Construct an object holding a UUID value
 class Hstore(dict):
     """Wrapper class for marking hstore values."""
 
-    _re_quote = regex('^[Nn][Uu][Ll][Ll]$|[ ,=>]')
-    _re_escape = regex(r'(["\\])')
+    _re_quote = _LazyRegex('^[Nn][Uu][Ll][Ll]$|[ ,=>]')
+    _re_escape = _LazyRegex(r'(["\\])')
 
     @classmethod
     def _quote(cls, s):
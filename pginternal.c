@@ -25,6 +25,80 @@
 /* Array types */
 #define PYGRES_ARRAY 16
 
+/* Functions for the arena allocator used for transient parse scratch */
+
+/* Allocate memory from the arena, adding a new block when the newest
+   block has not enough room left.  Returns NULL when out of memory. */
+static void *
+_arena_alloc(pgArena *arena, size_t size)
+{
+    arenaBlock *block = arena->block;
+    void *mem;
+
+    size = (size + 7) & ~(size_t) 7; /* keep allocations aligned */
+    if (!block || arena->used + size > block->size) {
+        size_t block_size = size > ARENA_BLOCK_SIZE ?
+            size : ARENA_BLOCK_SIZE;
+
+        block = (arenaBlock *) PyMem_Malloc(
+            sizeof(arenaBlock) + block_size);
+        if (!block) return NULL;
+        block->next = arena->block; block->size = block_size;
+        arena->block = block; arena->used = 0;
+    }
+    mem = (char *) (block + 1) + arena->used;
+    arena->used += size;
+    return mem;
+}
+
+/* Reset the arena so that its memory can be reused.  The newest (and
+   largest) block is kept for reuse, all older blocks are freed. */
+static void
+_arena_reset(pgArena *arena)
+{
+    arenaBlock *block = arena->block ? arena->block->next : NULL;
+
+    while (block) {
+        arenaBlock *next = block->next;
+
+        PyMem_Free(block); block = next;
+    }
+    if (arena->block) arena->block->next = NULL;
+    arena->used = 0;
+}
+
+/* Release all memory held by the arena. */
+static void
+_arena_release(pgArena *arena)
+{
+    arenaBlock *block = arena->block;
+
+    while (block) {
+        arenaBlock *next = block->next;
+
+        PyMem_Free(block); block = next;
+    }
+    arena->block = NULL; arena->used = 0;
+}
+
+/* Allocate transient parse scratch memory.  The memory comes from the
+   active scratch arena when one is set (during the casting of query
+   result values), and from the general allocator otherwise. */
+static void *
+_scratch_alloc(size_t size)
+{
+    return scratch_arena ?
+        _arena_alloc(scratch_arena, size) : PyMem_Malloc(size);
+}
+
+/* Free memory obtained with _scratch_alloc().  Arena memory is simply
+   kept until the arena is reset or released. */
+static void
+_scratch_free(void *mem)
+{
+    if (!scratch_arena) PyMem_Free(mem);
+}
+
 /* Shared functions for encoding and decoding strings */
 
 static PyObject *
@@ -189,6 +263,40 @@ get_col_types(PGresult *result, int nfields)
     return types;
 }
 
+/* Get the PyGreSQL internal type used for casting a column natively
+   in the DB-API 2 module. Unlike get_type(), this does not depend on
+   the module-level settings, since the DB-API 2 module has its own
+   typecast registry and only requests native casts for types whose
+   conversion is not configurable. */
+static int
+get_dbapi_type(Oid pgtype)
+{
+    switch (pgtype) {
+        case INT2OID:
+        case INT4OID:
+        case CIDOID:
+        case OIDOID:
+        case XIDOID:
+            return PYGRES_INT;
+
+        case INT8OID:
+            return PYGRES_LONG;
+
+        case FLOAT4OID:
+        case FLOAT8OID:
+            return PYGRES_FLOAT;
+
+        case BOOLOID:
+            return PYGRES_BOOL;
+
+        case BYTEAOID:
+            return PYGRES_BYTEA;
+
+        default:
+            return PYGRES_TEXT;
+    }
+}
+
 /* Cast a bytea encoded text based type to a Python object.
    This assumes the text is null-terminated character string. */
 static PyObject *
@@ -221,14 +329,14 @@ cast_sized_text(char *s, Py_ssize_t size, int encoding, int type)
         case PYGRES_BYTEA:
             /* this type should not be passed when bytea_escaped is set */
             /* we need to add a null byte */
-            tmp_str = (char *) PyMem_Malloc((size_t) size + 1);
+            tmp_str = (char *) _scratch_alloc((size_t) size + 1);
             if (!tmp_str) {
                 return PyErr_NoMemory();
             }
             memcpy(tmp_str, s, (size_t) size);
             s = tmp_str; *(s + size) = '\0';
             tmp_str = (char *) PQunescapeBytea((unsigned char*) s, &str_len);
-            PyMem_Free(s);
+            _scratch_free(s);
             if (!tmp_str) return PyErr_NoMemory();
             obj = PyBytes_FromStringAndSize(tmp_str, (Py_ssize_t) str_len);
             if (tmp_str) {
@@ -276,6 +384,118 @@ cast_other(char *s, Py_ssize_t size, int encoding, Oid pgtype,
     return obj;
 }
 
+/* Parse a plain numeric text representation directly into a 64 bit
+   integer scaled by decimal_scale fractional digits.  Returns 0 and
+   stores the value in *result on success, or -1 when the value cannot
+   be represented exactly as a scaled 64 bit integer. */
+static int
+scale_numeric_text(char *s, Py_ssize_t size, PY_LONG_LONG *result)
+{
+    char *end = s + size;
+    unsigned PY_LONG_LONG v = 0;
+    int neg = 0, frac = -1, digits = 0;
+
+    if (s < end && (*s == '-' || *s == '+')) {
+        neg = *s == '-'; ++s;
+    }
+    while (s < end) {
+        char c = *s++;
+
+        if (c >= '0' && c <= '9') {
+            if (frac >= 0 && ++frac > decimal_scale)
+                return -1; /* more fractional digits than the scale */
+            if (v > ((unsigned PY_LONG_LONG) PY_LLONG_MAX
+                     - (unsigned PY_LONG_LONG) (c - '0')) / 10)
+                return -1; /* does not fit into 64 bits */
+            v = v * 10 + (unsigned PY_LONG_LONG) (c - '0'); ++digits;
+        }
+        else if (c == '.' && frac < 0) {
+            frac = 0;
+        }
+        else { /* exponent or special value such as NaN */
+            return -1;
+        }
+    }
+    if (!digits) return -1;
+    for (frac = frac < 0 ? 0 : frac; frac < decimal_scale; ++frac) {
+        if (v > (unsigned PY_LONG_LONG) PY_LLONG_MAX / 10) return -1;
+        v *= 10;
+    }
+    *result = neg ? -(PY_LONG_LONG) v : (PY_LONG_LONG) v;
+    return 0;
+}
+
+/* Cast a plain numeric text representation directly to a Python object,
+   bypassing the construction of an intermediate Python string.  When a
+   fixed decimal scale is set, the value is returned as an integer
+   scaled to that number of fractional digits; otherwise the standard
+   decimal type is instantiated through its sign/digits/exponent tuple
+   constructor.  Returns NULL without setting an exception when the
+   value must be handled by the generic text based path instead. */
+static PyObject *
+cast_numeric_fast(char *s, Py_ssize_t size)
+{
+    static PyObject *std_decimal = NULL; /* the standard decimal type */
+    PyObject *digits, *obj;
+    char *t, *end = s + size;
+    int sign = 0, exponent = 0, frac = -1;
+    Py_ssize_t n = 0, i;
+
+    if (decimal_scale >= 0) {
+        PY_LONG_LONG v;
+
+        if (!scale_numeric_text(s, size, &v))
+            return PyLong_FromLongLong(v);
+    }
+
+    if (!std_decimal) { /* look up the standard decimal type only once */
+        PyObject *mod = PyImport_ImportModule("decimal");
+
+        if (!mod) {
+            PyErr_Clear(); return NULL;
+        }
+        std_decimal = PyObject_GetAttrString(mod, "Decimal");
+        Py_DECREF(mod);
+        if (!std_decimal) {
+            PyErr_Clear(); return NULL;
+        }
+    }
+    if (decimal != std_decimal)
+        return NULL; /* a custom type may not accept the tuple */
+
+    if (s < end && (*s == '-' || *s == '+')) {
+        sign = *s == '-'; ++s;
+    }
+    for (t = s; t < end; ++t) {
+        if (*t >= '0' && *t <= '9') {
+            ++n;
+            if (frac >= 0) --exponent;
+        }
+        else if (*t == '.' && frac < 0) {
+            frac = 0;
+        }
+        else { /* exponent or special value such as NaN */
+            return NULL;
+        }
+    }
+    if (!n) return NULL;
+
+    if (!(digits = PyTuple_New(n))) return NULL;
+    for (i = 0; s < end; ++s) {
+        if (*s != '.') {
+            PyObject *dig = PyInt_FromLong(*s - '0');
+
+            if (!dig) {
+                Py_DECREF(digits); return NULL;
+            }
+            PyTuple_SET_ITEM(digits, i++, dig);
+        }
+    }
+    obj = PyObject_CallFunction(decimal, "((iOi))", sign, digits, exponent);
+    Py_DECREF(digits);
+    return obj;
+}
+
 /* Cast a simple type to a Python object.
    This needs a character string representation with a given size. */
 static PyObject *
@@ -331,8 +551,11 @@ cast_sized_simple(char *s, Py_ssize_t size, int type)
                     buf[j++] = '-';
                 }
             }
+            buf[j] = '\0';
+            if ((obj = cast_numeric_fast(buf, j)) || PyErr_Occurred()) {
+                break;
+            }
             if (decimal) {
-                buf[j] = '\0';
                 obj = PyObject_CallFunction(decimal, "(s)", buf);
             }
             else {
@@ -344,6 +567,9 @@ cast_sized_simple(char *s, Py_ssize_t size, int type)
             break;
 
         case PYGRES_DECIMAL:
+            if ((obj = cast_numeric_fast(s, size)) || PyErr_Occurred()) {
+                break;
+            }
             tmp_obj = PyStr_FromStringAndSize(s, size);
             obj = decimal ? PyObject_CallFunctionObjArgs(
                 decimal, tmp_obj, NULL) : PyFloat_FromString(tmp_obj);
@@ -412,6 +638,11 @@ cast_unsized_simple(char *s, int type)
             /* FALLTHROUGH */ /* no break here */
 
         case PYGRES_DECIMAL:
+            if ((obj = cast_numeric_fast(s, (Py_ssize_t) strlen(s)))
+                || PyErr_Occurred())
+            {
+                break;
+            }
             if (decimal) {
                 obj = PyObject_CallFunction(decimal, "(s)", s);
             }
@@ -441,6 +672,435 @@ cast_unsized_simple(char *s, int type)
     return obj;
 }
 
+/* Helper functions reading numbers in network byte order
+   from the binary wire representation of a value. */
+
+static int
+read_binary_int16(const char *s)
+{
+    const unsigned char *u = (const unsigned char *) s;
+
+    return (int) ((short) (((unsigned short) u[0] << 8) | u[1]));
+}
+
+static long
+read_binary_int32(const char *s)
+{
+    const unsigned char *u = (const unsigned char *) s;
+
+    return (long) ((int) (((unsigned int) u[0] << 24) |
+        ((unsigned int) u[1] << 16) | ((unsigned int) u[2] << 8) | u[3]));
+}
+
+static PY_LONG_LONG
+read_binary_int64(const char *s)
+{
+    const unsigned char *u = (const unsigned char *) s;
+    unsigned PY_LONG_LONG v = 0;
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        v = (v << 8) | u[i];
+    }
+    return (PY_LONG_LONG) v;
+}
+
+/* Helper functions writing numbers in network byte order
+   as the binary wire representation of a value. */
+
+static void
+write_binary_int16(char *s, int v)
+{
+    unsigned char *u = (unsigned char *) s;
+    unsigned short w = (unsigned short) v;
+
+    u[0] = (unsigned char) (w >> 8); u[1] = (unsigned char) w;
+}
+
+static void
+write_binary_int32(char *s, long v)
+{
+    unsigned char *u = (unsigned char *) s;
+    unsigned int w = (unsigned int) v;
+    int i;
+
+    for (i = 3; i >= 0; --i) {
+        u[i] = (unsigned char) w; w >>= 8;
+    }
+}
+
+static void
+write_binary_int64(char *s, PY_LONG_LONG v)
+{
+    unsigned char *u = (unsigned char *) s;
+    unsigned PY_LONG_LONG w = (unsigned PY_LONG_LONG) v;
+    int i;
+
+    for (i = 7; i >= 0; --i) {
+        u[i] = (unsigned char) w; w >>= 8;
+    }
+}
+
+/* Cast the binary wire representation of a numeric value to a Python
+   object, using the same decimal type as the text representation. */
+static PyObject *
+cast_binary_decimal(char *s, Py_ssize_t size)
+{
+    PyObject *obj, *tmp_obj;
+    char sbuf[64], *buf, *t;
+    int ndigits, weight, sign, dscale, dig, i, d;
+    size_t need;
+
+    if (size < 8) {
+        PyErr_SetString(PyExc_ValueError, "Invalid binary numeric value");
+        return NULL;
+    }
+    ndigits = read_binary_int16(s);
+    weight = read_binary_int16(s + 2);
+    sign = read_binary_int16(s + 4) & 0xffff;
+    dscale = read_binary_int16(s + 6);
+    s += 8;
+    if (ndigits < 0 || size < 8 + 2 * (Py_ssize_t) ndigits) {
+        PyErr_SetString(PyExc_ValueError, "Invalid binary numeric value");
+        return NULL;
+    }
+
+    /* reconstruct the decimal string representation */
+    need = 4 * ((size_t) ndigits + (weight > 0 ? (size_t) weight : 0) + 2)
+        + (size_t) dscale + 4;
+    buf = need > sizeof(sbuf) ? (char *) _scratch_alloc(need) : sbuf;
+    if (!buf) return PyErr_NoMemory();
+    t = buf;
+    if (sign == 0xc000) {
+        strcpy(t, "NaN"); t += 3;
+    }
+    else {
+        if (sign == 0x4000) *t++ = '-';
+        if (weight < 0) {
+            *t++ = '0'; i = 0;
+        }
+        else {
+            for (i = 0, d = weight; d >= 0; --d, ++i) {
+                dig = i < ndigits ? (int) read_binary_int16(s + 2 * i) : 0;
+                t += sprintf(t, i ? "%04d" : "%d", dig);
+            }
+        }
+        if (dscale > 0) {
+            char *frac;
+
+            *t++ = '.'; frac = t;
+            for (d = 0; d < dscale; d += 4, ++i) {
+                dig = i < ndigits ? (int) read_binary_int16(s + 2 * i) : 0;
+                t += sprintf(t, "%04d", dig);
+            }
+            t = frac + dscale; /* truncate to the wanted scale */
+        }
+        *t = '\0';
+    }
+
+    obj = cast_numeric_fast(buf, t - buf);
+    if (!obj && !PyErr_Occurred()) {
+        if (decimal) {
+            obj = PyObject_CallFunction(
+                decimal, "(s#)", buf, (Py_ssize_t)(t - buf));
+        }
+        else {
+            tmp_obj = PyStr_FromStringAndSize(buf, t - buf);
+            obj = PyFloat_FromString(tmp_obj);
+            Py_DECREF(tmp_obj);
+        }
+    }
+    if (buf != sbuf) _scratch_free(buf);
+    return obj;
+}
+
+/* Cast the binary wire representation of a date/time value to a Python
+   object from the datetime module, which is imported on first use. */
+static PyObject *
+cast_binary_datetime(char *s, Py_ssize_t size, Oid pgtype)
+{
+    PyObject *base = NULL, *delta = NULL, *obj;
+    PY_LONG_LONG v, days, rem;
+
+    if (!PyDateTimeAPI) {
+        PyDateTime_IMPORT;
+        if (!PyDateTimeAPI) return NULL;
+    }
+
+    switch (pgtype) {
+
+        case DATEOID:
+            if (size < 4) break;
+            days = read_binary_int32(s);
+            /* infinite dates are mapped to the min/max values */
+            if (days == 0x7fffffffL || days == (-0x7fffffffL - 1))
+                return PyObject_GetAttrString(
+                    (PyObject *) PyDateTimeAPI->DateType,
+                    days > 0 ? "max" : "min");
+            base = PyDate_FromDate(2000, 1, 1);
+            delta = PyDelta_FromDSU((int) days, 0, 0);
+            break;
+
+        case TIMEOID:
+            if (size < 8) break;
+            v = read_binary_int64(s);
+            return PyTime_FromTime(
+                (int) (v / 3600000000LL), (int) (v / 60000000 % 60),
+                (int) (v / 1000000 % 60), (int) (v % 1000000));
+
+        case TIMESTAMPOID:
+        case TIMESTAMPTZOID:
+            if (size < 8) break;
+            v = read_binary_int64(s);
+            /* infinite timestamps are mapped to the min/max values */
+            if (v == PY_LLONG_MAX || v == PY_LLONG_MIN)
+                return PyObject_GetAttrString(
+                    (PyObject *) PyDateTimeAPI->DateTimeType,
+                    v > 0 ? "max" : "min");
+            days = v / 86400000000LL; rem = v % 86400000000LL;
+            if (rem < 0) {
+                rem += 86400000000LL; --days;
+            }
+            base = PyDateTime_FromDateAndTime(2000, 1, 1, 0, 0, 0, 0);
+            delta = PyDelta_FromDSU(
+                (int) days, (int) (rem / 1000000), (int) (rem % 1000000));
+            break;
+    }
+
+    if (!base || !delta) {
+        Py_XDECREF(base); Py_XDECREF(delta);
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_ValueError,
+                            "Invalid binary date/time value");
+        return NULL;
+    }
+    obj = PyNumber_Add(base, delta);
+    Py_DECREF(base); Py_DECREF(delta);
+    return obj;
+}
+
+static PyObject *cast_binary_value(
+    char *s, Py_ssize_t size, int encoding, int type, Oid pgtype);
+
+/* Cast the elements of one dimension of a binary array (internal use). */
+static PyObject *
+_cast_binary_array_dim(char **sp, char *end, long *dims, int ndims,
+                       int encoding, int etype, Oid elemtype)
+{
+    PyObject *result;
+    long i;
+
+    if (!(result = PyList_New(dims[0]))) {
+        return NULL;
+    }
+    for (i = 0; i < dims[0]; ++i) {
+        PyObject *element;
+
+        if (ndims > 1) {
+            element = _cast_binary_array_dim(
+                sp, end, dims + 1, ndims - 1, encoding, etype, elemtype);
+        }
+        else {
+            long esize;
+
+            if (end - *sp < 4) {
+                PyErr_SetString(PyExc_ValueError, "Truncated binary array");
+                Py_DECREF(result); return NULL;
+            }
+            esize = read_binary_int32(*sp); *sp += 4;
+            if (esize == -1) { /* NULL gives None */
+                Py_INCREF(Py_None); element = Py_None;
+            }
+            else if (esize < 0 || end - *sp < esize) {
+                PyErr_SetString(PyExc_ValueError, "Truncated binary array");
+                Py_DECREF(result); return NULL;
+            }
+            else {
+                element = cast_binary_value(
+                    *sp, esize, encoding, etype, elemtype);
+                *sp += esize;
+            }
+        }
+        if (!element) {
+            Py_DECREF(result); return NULL;
+        }
+        PyList_SET_ITEM(result, i, element);
+    }
+    return result;
+}
+
+/* Cast an array in binary wire format to a Python list.
+   The element type is taken from the array header itself. */
+static PyObject *
+cast_binary_array(char *s, Py_ssize_t size, int encoding)
+{
+    char *end = s + size;
+    long dims[MAX_ARRAY_DEPTH];
+    Oid elemtype;
+    int ndims, etype, i;
+
+    if (size < 12) {
+        PyErr_SetString(PyExc_ValueError, "Invalid binary array value");
+        return NULL;
+    }
+    ndims = (int) read_binary_int32(s);
+    /* the flags in the second word are ignored */
+    elemtype = (Oid) read_binary_int32(s + 8);
+    s += 12;
+    if (ndims < 0 || ndims > MAX_ARRAY_DEPTH) {
+        PyErr_SetString(PyExc_ValueError, "Array is too deeply nested");
+        return NULL;
+    }
+    if (!ndims) { /* empty array */
+        return PyList_New(0);
+    }
+    if (end - s < 8 * ndims) {
+        PyErr_SetString(PyExc_ValueError, "Invalid binary array value");
+        return NULL;
+    }
+    for (i = 0; i < ndims; ++i) {
+        dims[i] = read_binary_int32(s); s += 8; /* skip the lower bound */
+        if (dims[i] < 0) {
+            PyErr_SetString(PyExc_ValueError, "Invalid binary array value");
+            return NULL;
+        }
+    }
+    etype = get_type(elemtype) & ~PYGRES_ARRAY;
+    return _cast_binary_array_dim(
+        &s, end, dims, ndims, encoding, etype, elemtype);
+}
+
+/* Cast a value in binary wire format to a Python object.
+   This is the counterpart of the text format cast functions above and
+   needs the raw value, its size, the client encoding, the PyGreSQL
+   internal type and the PostgreSQL type of the column.  Values of
+   types that have no binary cast kernel are returned as raw bytes. */
+static PyObject *
+cast_binary_value(char *s, Py_ssize_t size, int encoding, int type, Oid pgtype)
+{
+    PyObject *obj, *tmp_obj;
+    PY_LONG_LONG v;
+
+    if (type & PYGRES_ARRAY)
+        return cast_binary_array(s, size, encoding);
+
+    switch (type) { /* this must be the PyGreSQL internal type */
+
+        case PYGRES_INT:
+            if (size == 2) {
+                obj = PyInt_FromLong((long) read_binary_int16(s));
+            }
+            else if (size == 4) {
+                obj = PyInt_FromLong(read_binary_int32(s));
+            }
+            else {
+                PyErr_SetString(PyExc_ValueError,
+                                "Invalid binary integer value");
+                obj = NULL;
+            }
+            break;
+
+        case PYGRES_LONG:
+            if (size == 8) {
+                obj = PyLong_FromLongLong(read_binary_int64(s));
+            }
+            else {
+                PyErr_SetString(PyExc_ValueError,
+                                "Invalid binary integer value");
+                obj = NULL;
+            }
+            break;
+
+        case PYGRES_FLOAT:
+            if (size == 4) {
+                union { unsigned int i; float f; } u;
+
+                u.i = (unsigned int) read_binary_int32(s);
+                obj = PyFloat_FromDouble((double) u.f);
+            }
+            else if (size == 8) {
+                union { unsigned PY_LONG_LONG i; double f; } u;
+
+                u.i = (unsigned PY_LONG_LONG) read_binary_int64(s);
+                obj = PyFloat_FromDouble(u.f);
+            }
+            else {
+                PyErr_SetString(PyExc_ValueError,
+                                "Invalid binary float value");
+                obj = NULL;
+            }
+            break;
+
+        case PYGRES_DECIMAL:
+            obj = cast_binary_decimal(s, size);
+            break;
+
+        case PYGRES_MONEY:
+            /* this type should only be passed when decimal_point is set */
+            v = size == 8 ? read_binary_int64(s) : 0;
+            {
+                char buf[32];
+                int neg = v < 0;
+
+                if (neg) v = -v;
+                sprintf(buf, "%s%lld.%02d", neg ? "-" : "",
+                        v / 100, (int) (v % 100));
+                if (decimal) {
+                    obj = PyObject_CallFunction(decimal, "(s)", buf);
+                }
+                else {
+                    tmp_obj = PyStr_FromString(buf);
+                    obj = PyFloat_FromString(tmp_obj);
+                    Py_DECREF(tmp_obj);
+                }
+            }
+            break;
+
+        case PYGRES_BOOL:
+            /* convert to bool only if bool_as_text is not set */
+            if (bool_as_text) {
+                obj = PyStr_FromString(*s ? "t" : "f");
+            }
+            else {
+                obj = *s ? Py_True : Py_False;
+                Py_INCREF(obj);
+            }
+            break;
+
+        case PYGRES_BYTEA:
+            /* the binary representation needs no unescaping */
+            obj = PyBytes_FromStringAndSize(s, size);
+            break;
+
+        case PYGRES_JSON:
+            if (pgtype == JSONBOID && size > 0) {
+                ++s; --size; /* skip the jsonb version byte */
+            }
+            obj = cast_sized_text(s, size, encoding, PYGRES_JSON);
+            break;
+
+        case PYGRES_TEXT:
+            obj = cast_sized_text(s, size, encoding, PYGRES_TEXT);
+            break;
+
+        default: /* PYGRES_OTHER */
+            switch (pgtype) {
+                case DATEOID:
+                case TIMEOID:
+                case TIMESTAMPOID:
+                case TIMESTAMPTZOID:
+                    obj = cast_binary_datetime(s, size, pgtype);
+                    break;
+                default:
+                    /* unknown types are returned as raw bytes,
+                       the cast hook expects text and is not called here */
+                    obj = PyBytes_FromStringAndSize(s, size);
+            }
+    }
+
+    return obj;
+}
+
 /* Quick case insensitive check if given sized string is null. */
 #define STR_IS_NULL(s, n) (n == 4 && \
     (s[0] == 'n' || s[0] == 'N') && \
@@ -448,6 +1108,261 @@ cast_unsized_simple(char *s, int type)
     (s[2] == 'l' || s[2] == 'L') && \
     (s[3] == 'l' || s[3] == 'L'))
 
+/* The following helpers scan ahead to the next character that needs
+   special treatment when parsing array or record literals.  On x86 they
+   compare 16 characters at a time using SSE2 intrinsics, so that long
+   stretches of ordinary characters are skipped in a few instructions. */
+
+/* Scan for the delimiter, a quote, a backslash or a brace. */
+static char *
+_scan_array_special(char *s, char *end, char delim)
+{
+#if defined(__SSE2__) && defined(__GNUC__)
+    const __m128i c_delim = _mm_set1_epi8(delim);
+    const __m128i c_quote = _mm_set1_epi8('"');
+    const __m128i c_bslash = _mm_set1_epi8('\\');
+    const __m128i c_open = _mm_set1_epi8('{');
+    const __m128i c_close = _mm_set1_epi8('}');
+
+    while (end - s >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) s);
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, c_delim),
+                         _mm_cmpeq_epi8(chunk, c_quote)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, c_bslash),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, c_open),
+                                      _mm_cmpeq_epi8(chunk, c_close))));
+        unsigned mask = (unsigned) _mm_movemask_epi8(found);
+
+        if (mask) return s + __builtin_ctz(mask);
+        s += 16;
+    }
+#endif /* __SSE2__ */
+    while (s != end && *s != delim && *s != '"' && *s != '\\' &&
+           *s != '{' && *s != '}')
+    {
+        ++s;
+    }
+    return s;
+}
+
+/* Scan for a quote or a backslash, inside a quoted element. */
+static char *
+_scan_quoted_special(char *s, char *end)
+{
+#if defined(__SSE2__) && defined(__GNUC__)
+    const __m128i c_quote = _mm_set1_epi8('"');
+    const __m128i c_bslash = _mm_set1_epi8('\\');
+
+    while (end - s >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) s);
+        __m128i found = _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, c_quote),
+            _mm_cmpeq_epi8(chunk, c_bslash));
+        unsigned mask = (unsigned) _mm_movemask_epi8(found);
+
+        if (mask) return s + __builtin_ctz(mask);
+        s += 16;
+    }
+#endif /* __SSE2__ */
+    while (s != end && *s != '"' && *s != '\\') {
+        ++s;
+    }
+    return s;
+}
+
+/* Scan for the delimiter, a quote, a backslash or a closing paren. */
+static char *
+_scan_record_special(char *s, char *end, char delim)
+{
+#if defined(__SSE2__) && defined(__GNUC__)
+    const __m128i c_delim = _mm_set1_epi8(delim);
+    const __m128i c_quote = _mm_set1_epi8('"');
+    const __m128i c_bslash = _mm_set1_epi8('\\');
+    const __m128i c_close = _mm_set1_epi8(')');
+
+    while (end - s >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) s);
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, c_delim),
+                         _mm_cmpeq_epi8(chunk, c_quote)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, c_bslash),
+                         _mm_cmpeq_epi8(chunk, c_close)));
+        unsigned mask = (unsigned) _mm_movemask_epi8(found);
+
+        if (mask) return s + __builtin_ctz(mask);
+        s += 16;
+    }
+#endif /* __SSE2__ */
+    while (s != end && *s != delim && *s != '"' && *s != '\\' &&
+           *s != ')')
+    {
+        ++s;
+    }
+    return s;
+}
+
+/* Count the occurrences of the given character in the given region,
+   using memchr() which is typically vectorized by the C library. */
+static Py_ssize_t
+_count_char(const char *s, const char *end, char c)
+{
+    Py_ssize_t count = 0;
+
+    while ((s = (const char *) memchr(s, c, (size_t) (end - s)))) {
+        ++count; ++s;
+    }
+    return count;
+}
+
+/* Parse a flat (one-dimensional) array literal in a single pass.
+   This is the fast path for the most common case, called by cast_array()
+   with s pointing past the opening brace.  The result list is pre-sized
+   using a fast delimiter count and quoted elements are unescaped into
+   one reusable scratch buffer instead of one allocation per element. */
+static PyObject *
+_cast_flat_array(char *s, char *end, int encoding,
+                 int type, PyObject *cast, char delim)
+{
+    PyObject **items, *result = NULL;
+    char *scratch = NULL, *t;
+    Py_ssize_t num = 0, capacity;
+
+    /* the number of elements cannot exceed the delimiter count plus
+       one, so the result can be built without growing any buffers */
+    capacity = _count_char(s, end, delim) + 1;
+    items = (PyObject **) _scratch_alloc(
+        (size_t) capacity * sizeof(PyObject *));
+    if (!items) return PyErr_NoMemory();
+
+    while (s != end) {
+        PyObject *element;
+        char *estr;
+        Py_ssize_t esize;
+        int escaped = 0;
+
+        if (*s == '}') break; /* end of array */
+        if (*s == '{') {
+            PyErr_SetString(PyExc_ValueError,
+                            "Subarray found where not expected");
+            goto cleanup;
+        }
+        if (*s == '"') { /* quoted element */
+            estr = ++s;
+            for (;;) {
+                s = _scan_quoted_special(s, end);
+                if (s == end || *s == '"') break;
+                /* skip the backslash and the escaped character */
+                ++s; if (s == end) break;
+                escaped = 1;
+                ++s;
+            }
+            if (s == end) break; /* error */
+            esize = s - estr;
+            do ++s; while (s != end && *s == ' ');
+        }
+        else { /* unquoted element */
+            estr = s;
+            /* can contain blanks inside */
+            for (;;) {
+                s = _scan_array_special(s, end, delim);
+                if (s == end || *s != '\\') break;
+                /* skip the backslash and the escaped character */
+                ++s; if (s == end) break;
+                escaped = 1;
+                ++s;
+            }
+            t = s; while (t > estr && *(t - 1) == ' ') --t;
+            if (!(esize = t - estr)) {
+                s = end; break; /* error */
+            }
+            if (STR_IS_NULL(estr, esize)) /* NULL gives None */
+                estr = NULL;
+        }
+        if (s == end) break; /* error */
+        if (estr) {
+            if (escaped) {
+                char *r;
+                Py_ssize_t i;
+
+                /* create unescaped string in the scratch buffer, which
+                   is large enough for this and all following elements */
+                if (!scratch) {
+                    scratch = (char *) _scratch_alloc((size_t) (end - estr));
+                    if (!scratch) {
+                        PyErr_NoMemory(); goto cleanup;
+                    }
+                }
+                t = estr;
+                for (i = 0, r = scratch; i < esize; ++i) {
+                    if (*t == '\\') ++t, ++i;
+                    *r++ = *t++;
+                }
+                estr = scratch;
+                esize = r - scratch;
+            }
+            if (type) { /* internal casting of base type */
+                if (type & PYGRES_TEXT)
+                    element = cast_sized_text(estr, esize, encoding, type);
+                else
+                    element = cast_sized_simple(estr, esize, type);
+            }
+            else { /* external casting of base type */
+#if IS_PY3
+                element = encoding == pg_encoding_ascii ? NULL :
+                    get_decoded_string(estr, esize, encoding);
+                if (!element) /* no decoding necessary or possible */
+#endif
+                element = PyBytes_FromStringAndSize(estr, esize);
+                if (element && cast) {
+                    PyObject *tmp = element;
+                    element = PyObject_CallFunctionObjArgs(
+                        cast, element, NULL);
+                    Py_DECREF(tmp);
+                }
+            }
+            if (!element) goto cleanup;
+        }
+        else {
+            Py_INCREF(Py_None); element = Py_None;
+        }
+        items[num++] = element;
+        if (*s == delim) {
+            do ++s; while (s != end && *s == ' ');
+            if (s == end) break; /* error */
+        }
+        else if (*s != '}') break; /* error */
+    }
+    if (s == end || *s != '}') {
+        PyErr_SetString(PyExc_ValueError,
+                        "Unexpected end of array");
+        goto cleanup;
+    }
+    do ++s; while (s != end && *s == ' ');
+    if (s != end) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Unexpected characters after end of array");
+        goto cleanup;
+    }
+
+    if ((result = PyList_New(num))) {
+        Py_ssize_t i;
+
+        for (i = 0; i < num; ++i) {
+            PyList_SET_ITEM(result, i, items[i]);
+        }
+        num = 0; /* the references have been transferred */
+    }
+
+cleanup:
+    while (num) {
+        Py_DECREF(items[--num]);
+    }
+    _scratch_free(items);
+    if (scratch) _scratch_free(scratch);
+    return result;
+}
+
 /* Cast string s with size and encoding to a Python list,
    using the input and output syntax for arrays.
    Use internal type or cast function to cast elements.
@@ -519,9 +1434,13 @@ cast_array(char *s, Py_ssize_t size, int encoding,
         return NULL;
     }
     depth--; /* next level of parsing */
+    do ++s; while (s != end && *s == ' ');
+    if (!depth) {
+        /* flat arrays are parsed with the single-pass fast path */
+        return _cast_flat_array(s, end, encoding, type, cast, delim);
+    }
     result = PyList_New(0);
     if (!result) return NULL;
-    do ++s; while (s != end && *s == ' ');
     /* everything is set up, start parsing the array */
     while (s != end) {
         if (*s == '}') {
@@ -596,7 +1515,7 @@ cast_array(char *s, Py_ssize_t size, int encoding,
 
                     /* create unescaped string */
                     t = estr;
-                    estr = (char *) PyMem_Malloc((size_t) esize);
+                    estr = (char *) _scratch_alloc((size_t) esize);
                     if (!estr) {
                         Py_DECREF(result); return PyErr_NoMemory();
                     }
@@ -626,7 +1545,7 @@ cast_array(char *s, Py_ssize_t size, int encoding,
                         Py_DECREF(tmp);
                     }
                 }
-                if (escaped) PyMem_Free(estr);
+                if (escaped) _scratch_free(estr);
                 if (!element) {
                     Py_DECREF(result); return NULL;
                 }
@@ -731,6 +1650,10 @@ cast_record(char *s, Py_ssize_t size, int encoding,
                     ++s; if (s == end) break;
                 }
                 ++s, ++esize;
+                /* skip ahead over ordinary characters in one go */
+                t = quoted ? _scan_quoted_special(s, end)
+                           : _scan_record_special(s, end, delim);
+                esize += t - s; s = t;
             }
             if (s == end) break; /* error */
             if (estr + esize != s) {
@@ -739,7 +1662,7 @@ cast_record(char *s, Py_ssize_t size, int encoding,
                 escaped = 1;
                 /* create unescaped string */
                 t = estr;
-                estr = (char *) PyMem_Malloc((size_t) esize);
+                estr = (char *) _scratch_alloc((size_t) esize);
                 if (!estr) {
                     Py_DECREF(result); return PyErr_NoMemory();
                 }
@@ -798,7 +1721,7 @@ cast_record(char *s, Py_ssize_t size, int encoding,
                     }
                 }
             }
-            if (escaped) PyMem_Free(estr);
+            if (escaped) _scratch_free(estr);
             if (!element) {
                 Py_DECREF(result); return NULL;
             }
@@ -887,7 +1810,7 @@ cast_hstore(char *s, Py_ssize_t size, int encoding)
         size = s - key - key_esc;
         if (key_esc) {
             char *r = key, *t;
-            key = (char *) PyMem_Malloc((size_t) size);
+            key = (char *) _scratch_alloc((size_t) size);
             if (!key) {
                 Py_DECREF(result); return PyErr_NoMemory();
             }
@@ -900,7 +1823,7 @@ cast_hstore(char *s, Py_ssize_t size, int encoding)
             }
         }
         key_obj = cast_sized_text(key, size, encoding, PYGRES_TEXT);
-        if (key_esc) PyMem_Free(key);
+        if (key_esc) _scratch_free(key);
         if (!key_obj) {
             Py_DECREF(result); return NULL;
         }
@@ -948,7 +1871,7 @@ cast_hstore(char *s, Py_ssize_t size, int encoding)
             size = s - val - val_esc;
             if (val_esc) {
                 char *r = val, *t;
-                val = (char *) PyMem_Malloc((size_t) size);
+                val = (char *) _scratch_alloc((size_t) size);
                 if (!val) {
                     Py_DECREF(key_obj); Py_DECREF(result);
                     return PyErr_NoMemory();
@@ -962,7 +1885,7 @@ cast_hstore(char *s, Py_ssize_t size, int encoding)
                 }
             }
             val_obj = cast_sized_text(val, size, encoding, PYGRES_TEXT);
-            if (val_esc) PyMem_Free(val);
+            if (val_esc) _scratch_free(val);
             if (!val_obj) {
                 Py_DECREF(key_obj); Py_DECREF(result); return NULL;
             }
@@ -1362,15 +2285,77 @@ date_format_to_style(const char *s)
     }
 }
 
+/* Rank a server notice severity for filtering in the notice collector. */
+static int
+_notice_severity(const char *severity)
+{
+    if (!severity) return 0;
+    switch (severity[0]) {
+        case 'D': return 1; /* DEBUG */
+        case 'L': return 2; /* LOG */
+        case 'I': return 3; /* INFO */
+        case 'N': return 4; /* NOTICE */
+        case 'W': return 5; /* WARNING */
+        case 'E':
+        case 'F':
+        case 'P': return 6; /* ERROR, FATAL, PANIC */
+        default: return 0;
+    }
+}
+
 /* Internal wrapper for the notice receiver callback. */
 static void
 notice_receiver(void *arg, const PGresult *res)
 {
-    PyGILState_STATE gstate = PyGILState_Ensure();
     connObject *self = (connObject*) arg;
-    PyObject *func = self->notice_receiver;
+    PyGILState_STATE gstate;
+    PyObject *func;
+
+    if (self->notice_ring) {
+        /* Collect the raw notice into the ring buffer. This part runs
+           without taking the GIL and creates no Python objects, so that
+           chatty servers cost as little as possible. */
+        const char *severity, *message;
+#ifdef PG_DIAG_SEVERITY_NONLOCALIZED
+        severity = PQresultErrorField(res, PG_DIAG_SEVERITY_NONLOCALIZED);
+        if (!severity)
+            severity = PQresultErrorField(res, PG_DIAG_SEVERITY);
+#else
+        severity = PQresultErrorField(res, PG_DIAG_SEVERITY);
+#endif
+        message = PQresultErrorField(res, PG_DIAG_MESSAGE_PRIMARY);
+        if (!severity) severity = "NOTICE";
+        if (!message) message = "";
+        if (_notice_severity(severity) >= self->notice_level) {
+            size_t severity_len = strlen(severity), len = strlen(message);
+            /* store the pair back to back as "severity\0message\0" */
+            char *entry = malloc(severity_len + len + 2);
+            if (entry) {
+                int slot;
+                memcpy(entry, severity, severity_len + 1);
+                memcpy(entry + severity_len + 1, message, len + 1);
+                if (self->notice_count == self->notice_size) {
+                    /* ring is full, drop the oldest collected notice */
+                    free(self->notice_ring[self->notice_head]);
+                    self->notice_ring[self->notice_head] = NULL;
+                    self->notice_head =
+                        (self->notice_head + 1) % self->notice_size;
+                    --self->notice_count;
+                }
+                slot = (self->notice_head + self->notice_count)
+                    % self->notice_size;
+                self->notice_ring[slot] = entry;
+                ++self->notice_count;
+            }
+        }
+    }
 
-    if (func) {
+    func = self->notice_receiver;
+    if (!func) return;
+
+    gstate = PyGILState_Ensure();
+
+    {
         noticeObject *notice = PyObject_New(noticeObject, &noticeType);
         PyObject *ret;
         if (notice) {
@@ -215,6 +215,284 @@ large_read(largeObject *self, PyObject *args)
     return buffer;
 }
 
+/* Read from large object into a caller-provided buffer. */
+static char large_readinto__doc__[] =
+"readinto(buffer) -- read from large object into the given buffer\n\n"
+"The data is read directly into the writable buffer without creating\n"
+"an intermediate bytes object, and the number of bytes read is\n"
+"returned; zero means the end of the large object.  The object must\n"
+"be opened in read mode before calling this method.\n";
+
+static PyObject *
+large_readinto(largeObject *self, PyObject *args)
+{
+    Py_buffer view;
+    int size;
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "w*", &view)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method readinto() expects"
+                        " a writable buffer as argument");
+        return NULL;
+    }
+
+    /* checks validity */
+    if (!_check_lo_obj(self, CHECK_OPEN)) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    /* reads directly into the buffer with the GIL released */
+    Py_BEGIN_ALLOW_THREADS
+    size = lo_read(self->pgcnx->cnx, self->lo_fd, (char *) view.buf,
+                   view.len > INT_MAX ? (size_t) INT_MAX : (size_t) view.len);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&view);
+
+    if (size == -1) {
+        PyErr_SetString(PyExc_IOError, "Error while reading");
+        return NULL;
+    }
+
+    /* returns the number of bytes read */
+    return PyInt_FromLong(size);
+}
+
+/* Set the chunk size used when iterating over the large object. */
+static char large_chunks__doc__[] =
+"chunks(size) -- iterate over the large object in chunks of that size\n\n"
+"Sets the chunk size used when iterating over the large object and\n"
+"returns the object itself, so it can be used in a for loop.  The\n"
+"object must be opened in read mode before it is iterated over.\n";
+
+static PyObject *
+large_chunks(largeObject *self, PyObject *args)
+{
+    int size;
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "i", &size)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method chunks() takes an integer argument");
+        return NULL;
+    }
+
+    if (size <= 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Method chunks() takes a positive integer"
+                        " as argument");
+        return NULL;
+    }
+    self->chunk_size = size;
+
+    /* returns the object itself as the iterable */
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+/* Return the iterator for the large object. */
+static PyObject *
+large_iter(largeObject *self)
+{
+    /* checks validity */
+    if (!_check_lo_obj(self, CHECK_OPEN)) {
+        return NULL;
+    }
+
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+/* Return the next chunk when iterating over the large object. */
+static PyObject *
+large_iternext(largeObject *self)
+{
+    PyObject *buffer;
+    int size;
+
+    /* checks validity */
+    if (!_check_lo_obj(self, CHECK_OPEN)) {
+        return NULL;
+    }
+
+    /* allocate the chunk and read into it with the GIL released */
+    if (!(buffer = PyBytes_FromStringAndSize(NULL, self->chunk_size))) {
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    size = lo_read(self->pgcnx->cnx, self->lo_fd,
+                   PyBytes_AS_STRING((PyBytesObject *) buffer),
+                   (size_t) self->chunk_size);
+    Py_END_ALLOW_THREADS
+
+    if (size == -1) {
+        PyErr_SetString(PyExc_IOError, "Error while reading");
+        Py_DECREF(buffer);
+        return NULL;
+    }
+    if (!size) { /* end of the large object */
+        Py_DECREF(buffer);
+        return NULL; /* StopIteration */
+    }
+
+    /* resize buffer and returns it */
+    _PyBytes_Resize(&buffer, size);
+    return buffer;
+}
+
+/* Copy the large object to a file. */
+static char large_copyto__doc__[] =
+"copyto(file, [chunk_size]) -- copy the large object to the given file\n\n"
+"The file can be a file-like object or a plain file descriptor.\n"
+"The data is read from the current position in chunks of the given\n"
+"size; writes to a file descriptor happen directly in C, so the\n"
+"payload never passes through Python object memory.  The number of\n"
+"copied bytes is returned.  The object must be opened in read mode\n"
+"before calling this method.\n";
+
+static PyObject *
+large_copyto(largeObject *self, PyObject *args)
+{
+    PyObject *file_obj;             /* file-like object or descriptor */
+    PyObject *write_method = NULL;  /* write method of the file object */
+    char *buffer;                   /* the transfer buffer */
+    long total = 0;                 /* number of bytes copied */
+    int bufsize = COPY_BUFFER_SIZE, fd = -1, size;
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "O|i", &file_obj, &bufsize)) {
+        return NULL;
+    }
+    if (bufsize <= 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Method copyto() expects a positive chunk size");
+        return NULL;
+    }
+
+    /* checks validity */
+    if (!_check_lo_obj(self, CHECK_OPEN)) {
+        return NULL;
+    }
+
+    if (PyInt_Check(file_obj)) {
+        fd = (int) PyInt_AsLong(file_obj);
+        if (fd < 0) {
+            PyErr_SetString(PyExc_ValueError, "Invalid file descriptor");
+            return NULL;
+        }
+    }
+    else {
+        /* use the underlying descriptor of the file object if there
+           is one, so the whole copy can run without the GIL */
+        PyObject *fileno_method = PyObject_GetAttrString(file_obj, "fileno");
+
+        if (fileno_method) {
+            PyObject *fd_obj = PyObject_CallObject(fileno_method, NULL);
+
+            Py_DECREF(fileno_method);
+            if (fd_obj && PyInt_Check(fd_obj)) {
+                fd = (int) PyInt_AsLong(fd_obj);
+            }
+            Py_XDECREF(fd_obj);
+            if (!fd_obj) PyErr_Clear();
+        }
+        else {
+            PyErr_Clear();
+        }
+        if (fd >= 0) {
+            /* flush pending Python-level buffered data first, so the
+               chunks written directly to the descriptor stay in order */
+            PyObject *flush_method =
+                PyObject_GetAttrString(file_obj, "flush");
+
+            if (flush_method) {
+                PyObject *ret = PyObject_CallObject(flush_method, NULL);
+
+                Py_DECREF(flush_method);
+                if (!ret) return NULL;
+                Py_DECREF(ret);
+            }
+            else {
+                PyErr_Clear();
+            }
+        }
+        if (fd < 0 &&
+            !(write_method = PyObject_GetAttrString(file_obj, "write")))
+        {
+            PyErr_Clear();
+            PyErr_SetString(PyExc_TypeError,
+                            "Expected a file-like object"
+                            " or a file descriptor");
+            return NULL;
+        }
+    }
+
+    if (!(buffer = (char *) PyMem_Malloc((size_t) bufsize))) {
+        Py_XDECREF(write_method);
+        return PyErr_NoMemory();
+    }
+
+    for (;;) {
+        int failed = 0;
+
+        Py_BEGIN_ALLOW_THREADS
+        size = lo_read(self->pgcnx->cnx, self->lo_fd,
+                       buffer, (size_t) bufsize);
+        if (size > 0 && fd >= 0) {
+            /* write to the descriptor without reacquiring the GIL */
+            char *p = buffer;
+            Py_ssize_t left = size;
+
+            while (left > 0) {
+                Py_ssize_t written = (Py_ssize_t) fd_write(fd, p, left);
+
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    failed = 1; break;
+                }
+                p += written; left -= written;
+            }
+        }
+        Py_END_ALLOW_THREADS
+
+        if (size == -1) {
+            PyErr_SetString(PyExc_IOError, "Error while reading");
+            goto copy_error;
+        }
+        if (failed) {
+            PyErr_SetFromErrno(PyExc_IOError);
+            goto copy_error;
+        }
+        if (!size) break; /* end of the large object */
+
+        if (fd < 0) {
+            /* hand the chunk to the write method of the file object */
+            PyObject *chunk, *ret;
+
+            chunk = PyBytes_FromStringAndSize(buffer, size);
+            if (!chunk) goto copy_error;
+            ret = PyObject_CallFunctionObjArgs(write_method, chunk, NULL);
+            Py_DECREF(chunk);
+            if (!ret) goto copy_error;
+            Py_DECREF(ret);
+        }
+        total += size;
+    }
+
+    PyMem_Free(buffer);
+    Py_XDECREF(write_method);
+
+    /* returns the number of copied bytes */
+    return PyInt_FromLong(total);
+
+copy_error:
+    PyMem_Free(buffer);
+    Py_XDECREF(write_method);
+    return NULL;
+}
+
 /* Write to large object. */
 static char large_write__doc__[] =
 "write(string) -- write sized string to large object\n\n"
@@ -415,6 +693,12 @@ static struct PyMethodDef large_methods[] = {
     {"open", (PyCFunction) large_open, METH_VARARGS, large_open__doc__},
     {"close", (PyCFunction) large_close, METH_NOARGS, large_close__doc__},
     {"read", (PyCFunction) large_read, METH_VARARGS, large_read__doc__},
+    {"readinto", (PyCFunction) large_readinto,
+        METH_VARARGS, large_readinto__doc__},
+    {"chunks", (PyCFunction) large_chunks,
+        METH_VARARGS, large_chunks__doc__},
+    {"copyto", (PyCFunction) large_copyto,
+        METH_VARARGS, large_copyto__doc__},
     {"write", (PyCFunction) large_write, METH_VARARGS, large_write__doc__},
     {"seek", (PyCFunction) large_seek, METH_VARARGS, large_seek__doc__},
     {"size", (PyCFunction) large_size, METH_NOARGS, large_size__doc__},
@@ -455,7 +739,7 @@ static PyTypeObject largeType = {
     0,                             /* tp_clear */
     0,                             /* tp_richcompare */
     0,                             /* tp_weaklistoffset */
-    0,                             /* tp_iter */
-    0,                             /* tp_iternext */
+    (getiterfunc) large_iter,      /* tp_iter */
+    (iternextfunc) large_iternext, /* tp_iternext */
     large_methods,                 /* tp_methods */
 };
@@ -12,10 +12,37 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <datetime.h>
+
+/* The timedelta accessor macros are only available in Python 3.3+ */
+#ifndef PyDateTime_DELTA_GET_DAYS
+#define PyDateTime_DELTA_GET_DAYS(o) (((PyDateTime_Delta *) (o))->days)
+#define PyDateTime_DELTA_GET_SECONDS(o) (((PyDateTime_Delta *) (o))->seconds)
+#define PyDateTime_DELTA_GET_MICROSECONDS(o) \
+    (((PyDateTime_Delta *) (o))->microseconds)
+#endif
 
 #include <libpq-fe.h>
 #include <libpq/libpq-fs.h>
 
+/* SSE2 intrinsics used for scanning array and record literals */
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Used for the monotonic performance counters */
+#include <time.h>
+
+/* Used for waiting on notifications with the GIL released */
+#include <errno.h>
+#ifdef HAVE_POLL
+#include <poll.h>
+#elif defined(MS_WINDOWS)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
 /* The type definitions from <server/catalog/pg_type.h> */
 #include "pgtypes.h"
 
@@ -37,6 +64,7 @@ static const char *PyPgVersion = TOSTRING(PYGRESQL_VERSION);
 
 /* Default values */
 #define PG_ARRAYSIZE 1
+#define STMT_CACHE_SIZE 64  /* default size of the statement cache */
 
 /* Flags for object validity checks */
 #define CHECK_OPEN   1
@@ -60,6 +88,32 @@ static const char *PyPgVersion = TOSTRING(PYGRESQL_VERSION);
 #define MAX_BUFFER_SIZE 8192  /* maximum transaction size */
 #define MAX_ARRAY_DEPTH 16    /* maximum allowed depth of an array */
 
+#define INTERN_CACHE_SLOTS 64  /* interned values cached per column */
+#define INTERN_CACHE_PROBES 4  /* linear probes before an entry is evicted */
+#define INTERN_MAX_SIZE 64     /* maximum size of interned cell values */
+
+#define ARENA_BLOCK_SIZE 8192  /* default block size of the scratch arena */
+
+#define COPY_BUFFER_SIZE 65536  /* default write size for copyfrom */
+
+/* Arena (bump) allocator for transient parse scratch memory.  The
+   memory is handed out by advancing a pointer in the newest block and
+   is given back by releasing or resetting the whole arena at once. */
+
+typedef struct arenaBlock
+{
+    struct arenaBlock *next; /* next (older) block in the chain */
+    size_t     size;         /* usable size of the block */
+    /* the usable memory follows the header */
+}   arenaBlock;
+
+typedef struct
+{
+    arenaBlock *block;       /* newest block in the chain */
+    size_t     used;         /* bytes used in the newest block */
+    int        active;       /* nesting depth of users, guards resets */
+}   pgArena;
+
 /* MODULE GLOBAL VARIABLES */
 
 #ifdef DEFAULT_VARS
@@ -79,9 +133,24 @@ static PyObject *decimal = NULL,    /* decimal type */
                 *jsondecode = NULL; /* function for decoding json strings */
 static const char *date_format = NULL; /* date format that is always assumed */
 static char decimal_point = '.';    /* decimal point used in money values */
+static int decimal_scale = -1; /* fixed scale for numeric values as ints */
 static int bool_as_text = 0;   /* whether bool shall be returned as text */
 static int array_as_text = 0;  /* whether arrays shall be returned as text */
 static int bytea_escaped = 0;  /* whether bytea shall be returned escaped */
+static int zerocopy = 0;  /* whether text/bytea shall be returned as views */
+static int interning = 0;  /* whether repeated result values shall be shared */
+static int binary_params = 0;  /* whether parameters are sent in binary form */
+static PyObject *shared_cache = NULL;  /* process-wide metadata cache */
+
+/* The active arena for parse scratch is kept in thread-local storage:
+   the cast helpers can call back into Python code where the GIL may
+   hand off to another thread casting values of a different query, so
+   a plain global pointer could leak one thread's arena into another. */
+#ifdef _MSC_VER
+static __declspec(thread) pgArena *scratch_arena = NULL;
+#else
+static __thread pgArena *scratch_arena = NULL;
+#endif
 
 static int pg_encoding_utf8 = 0;
 static int pg_encoding_latin1 = 0;
@@ -108,13 +177,51 @@ OBJECTS
 */
 
 /* Forward declarations for types */
-static PyTypeObject connType, sourceType, queryType, noticeType, largeType;
+static PyTypeObject connType, sourceType, queryType, lazyRowType,
+    viewType, noticeType, poolType, multiType, largeType;
+#if IS_PY3
+static PyTypeObject asyncQueryType;
+#endif
 
 /* Forward static declarations */
 static void notice_receiver(void *, const PGresult *);
 
+/* Return a monotonic timestamp in seconds for the perf counters. */
+static double
+_monotime(void)
+{
+#ifdef MS_WINDOWS
+    return (double) clock() / (double) CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+#endif
+}
+
 /* Object declarations */
 
+typedef struct
+{
+    char          *query;      /* text of the cached query */
+    char          name[32];    /* server-side statement name */
+    Oid           *param_types; /* parameter type OIDs, 0 = inferred */
+    int           num_params;  /* number of parameters */
+    unsigned long last_used;   /* LRU tick of the last execution */
+}   stmtCacheEntry;
+
+typedef struct
+{
+    unsigned long queries;       /* number of queries executed */
+    unsigned long rows;          /* number of rows built or sent */
+    unsigned PY_LONG_LONG bytes; /* number of value bytes processed */
+    double server_time;          /* seconds spent waiting for the server */
+    double cast_time;            /* seconds spent casting values */
+    unsigned long cache_hits;    /* statement cache hits */
+    unsigned long cache_misses;  /* statement cache misses */
+}   connStats;
+
 typedef struct
 {
     PyObject_HEAD
@@ -123,8 +230,21 @@ typedef struct
     const char *date_format;      /* date format derived from datestyle */
     PyObject   *cast_hook;        /* external typecast method */
     PyObject   *notice_receiver;  /* current notice receiver */
+    stmtCacheEntry *stmt_cache;   /* prepared-statement cache entries */
+    int        stmt_cache_size;   /* maximum number of cached statements */
+    int        stmt_cache_used;   /* current number of cached statements */
+    unsigned long stmt_cache_tick; /* LRU clock for the statement cache */
+    connStats  stats;             /* performance counters */
+    char     **notice_ring;       /* ring buffer with collected notices */
+    int        notice_size;       /* capacity of the ring buffer */
+    int        notice_head;       /* index of the oldest collected notice */
+    int        notice_count;      /* number of collected notices */
+    int        notice_level;      /* minimum severity that is collected */
+    int        query_capture;     /* whether query timings are captured */
+    double     explain_threshold; /* elapsed seconds triggering the hook */
+    PyObject  *explain_hook;      /* callback receiving sampled plans */
 }   connObject;
-#define is_connObject(v) (PyType(v) == &connType)
+#define is_connObject(v) (Py_TYPE(v) == &connType)
 
 typedef struct
 {
@@ -139,7 +259,7 @@ typedef struct
     int        max_row;      /* number of rows in the result */
     int        num_fields;   /* number of fields in each row */
 }   sourceObject;
-#define is_sourceObject(v) (PyType(v) == &sourceType)
+#define is_sourceObject(v) (Py_TYPE(v) == &sourceType)
 
 typedef struct
 {
@@ -147,7 +267,14 @@ typedef struct
     connObject *pgcnx;    /* parent connection object */
     PGresult const *res;  /* an error or warning */
 }   noticeObject;
-#define is_noticeObject(v) (PyType(v) == &noticeType)
+#define is_noticeObject(v) (Py_TYPE(v) == &noticeType)
+
+typedef struct
+{
+    char       *data;    /* cell bytes inside the result storage */
+    Py_ssize_t size;     /* size of the cell bytes */
+    PyObject   *value;   /* shared Python object for these bytes */
+}   internEntry;
 
 typedef struct
 {
@@ -155,13 +282,75 @@ typedef struct
     connObject *pgcnx;       /* parent connection object */
     PGresult   *result;      /* result content */
     int        async;        /* flag for asynchronous queries */
+    int        streaming;    /* flag for single-row streaming mode */
     int        encoding;     /* client encoding */
     int        current_row;  /* currently selected row */
     int        max_row;      /* number of rows in the result */
     int        num_fields;   /* number of fields in each row */
     int        *col_types;   /* PyGreSQL column types */
+    PyObject   *named_row_type; /* struct sequence type for named rows */
+    internEntry *intern_cache;  /* per-column caches of shared values */
+    pgArena    arena;        /* arena for transient parse scratch */
+    double     elapsed;      /* wall time spent in libpq, -1 if not captured */
+    long       rows_affected; /* command tuples count, -1 if not captured */
 }   queryObject;
-#define is_queryObject(v) (PyType(v) == &queryType)
+#define is_queryObject(v) (Py_TYPE(v) == &queryType)
+
+typedef struct
+{
+    PyObject_HEAD
+    queryObject *query;   /* parent query object holding the result */
+    int         row;      /* row index in the query result */
+    PyObject    **values; /* memoized cell values, NULL when not accessed */
+}   lazyRowObject;
+#define is_lazyRowObject(v) (Py_TYPE(v) == &lazyRowType)
+
+typedef struct
+{
+    PyObject_HEAD
+    PyObject   *owner; /* object keeping the referenced data alive */
+    char       *mem;   /* memory freed with the view, or NULL */
+    char       *data;  /* start of the referenced data */
+    Py_ssize_t size;   /* size of the referenced data in bytes */
+}   viewObject;
+#define is_viewObject(v) (Py_TYPE(v) == &viewType)
+
+#if IS_PY3
+typedef struct
+{
+    PyObject_HEAD
+    connObject  *pgcnx;      /* connection the query was sent on */
+    queryObject *query;      /* the underlying asynchronous query */
+    PyObject    *loop;       /* the asyncio event loop driving the query */
+    PyObject    *wake;       /* callback waking up the pending future */
+    PyObject    *future;     /* future signaling socket readiness */
+    int         fd;          /* the socket of the connection */
+    int         watching;    /* 0 = none, 1 = reader, 2 = writer */
+    int         state;       /* 0 = flushing, 1 = reading, 2 = done */
+    int         nonblocking; /* previous non-blocking mode to restore */
+}   asyncQueryObject;
+#define is_asyncQueryObject(v) (Py_TYPE(v) == &asyncQueryType)
+#endif /* IS_PY3 */
+
+typedef struct
+{
+    PyObject_HEAD
+    PyObject  *args;    /* positional arguments for creating connections */
+    PyObject  *kwargs;  /* keyword arguments for creating connections */
+    PyObject **conns;   /* freelist of idle pooled connections */
+    int       size;     /* current number of idle connections */
+    int       maxsize;  /* capacity of the freelist */
+    int       reset;    /* whether the session is reset on release */
+}   poolObject;
+#define is_poolObject(v) (Py_TYPE(v) == &poolType)
+
+typedef struct
+{
+    PyObject_HEAD
+    PyObject **conns;     /* the member connection objects */
+    int       num_conns;  /* number of member connections */
+}   multiObject;
+#define is_multiObject(v) (Py_TYPE(v) == &multiType)
 
 #ifdef LARGE_OBJECTS
 typedef struct
@@ -170,8 +359,9 @@ typedef struct
     connObject *pgcnx;  /* parent connection object */
     Oid lo_oid;         /* large object oid */
     int lo_fd;          /* large object fd */
+    int chunk_size;     /* chunk size used when iterating */
 }   largeObject;
-#define is_largeObject(v) (PyType(v) == &largeType)
+#define is_largeObject(v) (Py_TYPE(v) == &largeType)
 #endif /* LARGE_OBJECTS */
 
 /* Internal functions */
@@ -194,6 +384,13 @@ typedef struct
 #include "pglarge.c"
 #endif
 
+/* Pool object (needs the connect function defined below) */
+static PyObject *pg_connect(PyObject *self, PyObject *args, PyObject *dict);
+#include "pgpool.c"
+
+/* Multi-connection object */
+#include "pgmulti.c"
+
 /* MODULE FUNCTIONS */
 
 /* Connect to a database. */
@@ -262,6 +459,19 @@ pg_connect(PyObject *self, PyObject *args, PyObject *dict)
     conn_obj->date_format = date_format;
     conn_obj->cast_hook = NULL;
     conn_obj->notice_receiver = NULL;
+    conn_obj->stmt_cache = NULL;
+    conn_obj->stmt_cache_size = STMT_CACHE_SIZE;
+    conn_obj->stmt_cache_used = 0;
+    conn_obj->stmt_cache_tick = 0;
+    memset(&conn_obj->stats, 0, sizeof(conn_obj->stats));
+    conn_obj->notice_ring = NULL;
+    conn_obj->notice_size = 0;
+    conn_obj->notice_head = 0;
+    conn_obj->notice_count = 0;
+    conn_obj->notice_level = 0;
+    conn_obj->query_capture = 0;
+    conn_obj->explain_threshold = 0;
+    conn_obj->explain_hook = NULL;
 
     if (pghost)
     {
@@ -587,6 +797,56 @@ pg_set_decimal(PyObject *self, PyObject *cls)
     return ret;
 }
 
+/* Get decimal scale. */
+static char pg_get_decimal_scale__doc__[] =
+"get_decimal_scale() -- get the fixed scale used for numeric values";
+
+static PyObject *
+pg_get_decimal_scale(PyObject *self, PyObject *noargs)
+{
+    if (decimal_scale >= 0) {
+        return PyInt_FromLong(decimal_scale);
+    }
+
+    Py_INCREF(Py_None); return Py_None;
+}
+
+/* Set decimal scale. */
+static char pg_set_decimal_scale__doc__[] =
+"set_decimal_scale(scale) -- return numeric values as scaled integers";
+
+static PyObject *
+pg_set_decimal_scale(PyObject *self, PyObject *arg)
+{
+    PyObject *ret = NULL;
+
+    if (arg == Py_None) {
+        decimal_scale = -1;
+        Py_INCREF(Py_None); ret = Py_None;
+    }
+    else if (PyInt_Check(arg)) {
+        long scale = PyInt_AsLong(arg);
+
+        /* values scaled by more than 18 digits can overflow 64 bits */
+        if (scale >= 0 && scale <= 18) {
+            decimal_scale = (int) scale;
+            Py_INCREF(Py_None); ret = Py_None;
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError,
+                            "Function set_decimal_scale() expects"
+                            " a scale between 0 and 18");
+        }
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function set_decimal_scale() expects"
+                        " an integer or None as argument");
+    }
+
+    return ret;
+}
+
 /* Get usage of bool values. */
 static char pg_get_bool__doc__[] =
 "get_bool() -- check whether boolean values are converted to bool";
@@ -704,6 +964,209 @@ pg_set_bytea_escaped(PyObject *self, PyObject *args)
     return ret;
 }
 
+/* Check whether text and bytea values are returned as views. */
+static char pg_get_zerocopy__doc__[] =
+"get_zerocopy() -- check whether text/bytea will be returned as views";
+
+static PyObject *
+pg_get_zerocopy(PyObject *self, PyObject *noargs)
+{
+    PyObject *ret;
+
+    ret = zerocopy ? Py_True : Py_False;
+    Py_INCREF(ret);
+
+    return ret;
+}
+
+/* Set usage of zero-copy result views. */
+static char pg_set_zerocopy__doc__[] =
+"set_zerocopy(on) -- set whether text/bytea will be returned as views";
+
+static PyObject *
+pg_set_zerocopy(PyObject *self, PyObject *args)
+{
+    PyObject *ret = NULL;
+    int i;
+
+    /* gets arguments */
+    if (PyArg_ParseTuple(args, "i", &i)) {
+        zerocopy = i ? 1 : 0;
+        Py_INCREF(Py_None); ret = Py_None;
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function set_zerocopy() expects"
+                        " a boolean value as argument");
+    }
+
+    return ret;
+}
+
+/* Get interning of repeated result values. */
+static char pg_get_interning__doc__[] =
+"get_interning() -- check whether repeated result values will be shared";
+
+static PyObject *
+pg_get_interning(PyObject *self, PyObject *noargs)
+{
+    PyObject *ret;
+
+    ret = interning ? Py_True : Py_False;
+    Py_INCREF(ret);
+
+    return ret;
+}
+
+/* Set interning of repeated result values. */
+static char pg_set_interning__doc__[] =
+"set_interning(on) -- set whether repeated result values will be shared";
+
+static PyObject *
+pg_set_interning(PyObject *self, PyObject *args)
+{
+    PyObject *ret = NULL;
+    int i;
+
+    /* gets arguments */
+    if (PyArg_ParseTuple(args, "i", &i)) {
+        interning = i ? 1 : 0;
+        Py_INCREF(Py_None); ret = Py_None;
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function set_interning() expects"
+                        " a boolean value as argument");
+    }
+
+    return ret;
+}
+
+/* Get binary encoding of query parameters. */
+static char pg_get_binary_params__doc__[] =
+"get_binary_params() -- check whether parameters will be sent in binary form";
+
+static PyObject *
+pg_get_binary_params(PyObject *self, PyObject *noargs)
+{
+    PyObject *ret;
+
+    ret = binary_params ? Py_True : Py_False;
+    Py_INCREF(ret);
+
+    return ret;
+}
+
+/* Set binary encoding of query parameters. */
+static char pg_set_binary_params__doc__[] =
+"set_binary_params(on) -- set whether parameters will be sent in binary form";
+
+static PyObject *
+pg_set_binary_params(PyObject *self, PyObject *args)
+{
+    PyObject *ret = NULL;
+    int i;
+
+    /* gets arguments */
+    if (PyArg_ParseTuple(args, "i", &i)) {
+        binary_params = i ? 1 : 0;
+        Py_INCREF(Py_None); ret = Py_None;
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function set_binary_params() expects"
+                        " a boolean value as argument");
+    }
+
+    return ret;
+}
+
+/* Get the process-wide shared metadata cache for a database. */
+static char pg_get_shared_cache__doc__[] =
+"get_shared_cache(key) -- get the shared metadata cache for a database\n\n"
+"The cache is a dictionary that is shared between all connections in\n"
+"the current process, so metadata discovered over one connection can\n"
+"be reused by all other connections to the same database.  The key\n"
+"should uniquely identify the database, e.g. 'host:port/dbname@user'.\n"
+"The cache for a given key is created atomically on first access.\n";
+
+static PyObject *
+pg_get_shared_cache(PyObject *self, PyObject *args)
+{
+    char *key;
+    PyObject *cache;
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "s", &key)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function get_shared_cache() expects"
+                        " a string as argument");
+        return NULL;
+    }
+
+    if (!shared_cache && !(shared_cache = PyDict_New())) {
+        return NULL;
+    }
+
+    /* the lookup and insertion both happen while we hold the GIL,
+       so the get-or-create is atomic between threads */
+    cache = PyDict_GetItemString(shared_cache, key);
+    if (!cache) {
+        if (!(cache = PyDict_New())) {
+            return NULL;
+        }
+        if (PyDict_SetItemString(shared_cache, key, cache)) {
+            Py_DECREF(cache); return NULL;
+        }
+        return cache;
+    }
+
+    Py_INCREF(cache);
+    return cache;
+}
+
+/* Clear the process-wide shared metadata cache. */
+static char pg_clear_shared_cache__doc__[] =
+"clear_shared_cache([key]) -- clear the shared metadata cache\n\n"
+"When a key is given, only the cache for that database is cleared,\n"
+"otherwise the caches for all databases are cleared.  This can be\n"
+"used to invalidate cached metadata after schema changes.\n";
+
+static PyObject *
+pg_clear_shared_cache(PyObject *self, PyObject *args)
+{
+    char *key = NULL;
+
+    /* gets arguments */
+    if (!PyArg_ParseTuple(args, "|s", &key)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function clear_shared_cache() expects"
+                        " a string as optional argument");
+        return NULL;
+    }
+
+    if (shared_cache) {
+        if (key) {
+            PyObject *cache = PyDict_GetItemString(shared_cache, key);
+
+            /* clear the cache itself instead of removing it, so
+               connections holding a reference see the invalidation */
+            if (cache) PyDict_Clear(cache);
+        }
+        else {
+            PyObject *db_key, *cache;
+            Py_ssize_t pos = 0;
+
+            while (PyDict_Next(shared_cache, &pos, &db_key, &cache)) {
+                PyDict_Clear(cache);
+            }
+        }
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 /* set query helper functions (not part of public API) */
 
 static char pg_set_query_helpers__doc__[] =
@@ -1177,6 +1640,10 @@ pg_cast_hstore(PyObject *self, PyObject *string)
 static struct PyMethodDef pg_methods[] = {
     {"connect", (PyCFunction) pg_connect,
         METH_VARARGS|METH_KEYWORDS, pg_connect__doc__},
+    {"pool", (PyCFunction) pg_pool,
+        METH_VARARGS|METH_KEYWORDS, pg_pool__doc__},
+    {"multiconnection", (PyCFunction) pg_multiconnection,
+        METH_VARARGS, pg_multiconnection__doc__},
     {"escape_string", (PyCFunction) pg_escape_string,
         METH_O, pg_escape_string__doc__},
     {"escape_bytea", (PyCFunction) pg_escape_bytea,
@@ -1195,6 +1662,10 @@ static struct PyMethodDef pg_methods[] = {
         METH_NOARGS, pg_get_decimal__doc__},
     {"set_decimal", (PyCFunction) pg_set_decimal,
         METH_O, pg_set_decimal__doc__},
+    {"get_decimal_scale", (PyCFunction) pg_get_decimal_scale,
+        METH_NOARGS, pg_get_decimal_scale__doc__},
+    {"set_decimal_scale", (PyCFunction) pg_set_decimal_scale,
+        METH_O, pg_set_decimal_scale__doc__},
     {"get_bool", (PyCFunction) pg_get_bool,
         METH_NOARGS, pg_get_bool__doc__},
     {"set_bool", (PyCFunction) pg_set_bool,
@@ -1209,6 +1680,22 @@ static struct PyMethodDef pg_methods[] = {
         METH_NOARGS, pg_get_bytea_escaped__doc__},
     {"set_bytea_escaped", (PyCFunction) pg_set_bytea_escaped,
         METH_VARARGS, pg_set_bytea_escaped__doc__},
+    {"get_zerocopy", (PyCFunction) pg_get_zerocopy,
+        METH_NOARGS, pg_get_zerocopy__doc__},
+    {"set_zerocopy", (PyCFunction) pg_set_zerocopy,
+        METH_VARARGS, pg_set_zerocopy__doc__},
+    {"get_interning", (PyCFunction) pg_get_interning,
+        METH_NOARGS, pg_get_interning__doc__},
+    {"set_interning", (PyCFunction) pg_set_interning,
+        METH_VARARGS, pg_set_interning__doc__},
+    {"get_binary_params", (PyCFunction) pg_get_binary_params,
+        METH_NOARGS, pg_get_binary_params__doc__},
+    {"set_binary_params", (PyCFunction) pg_set_binary_params,
+        METH_VARARGS, pg_set_binary_params__doc__},
+    {"get_shared_cache", (PyCFunction) pg_get_shared_cache,
+        METH_VARARGS, pg_get_shared_cache__doc__},
+    {"clear_shared_cache", (PyCFunction) pg_clear_shared_cache,
+        METH_VARARGS, pg_clear_shared_cache__doc__},
     {"get_jsondecode", (PyCFunction) pg_get_jsondecode,
         METH_NOARGS, pg_get_jsondecode__doc__},
     {"set_jsondecode", (PyCFunction) pg_set_jsondecode,
@@ -1260,14 +1747,17 @@ MODULE_INIT_FUNC(_pg)
 
     /* Initialize here because some Windows platforms get confused otherwise */
 #if IS_PY3
-    connType.tp_base = noticeType.tp_base =
-        queryType.tp_base = sourceType.tp_base = &PyBaseObject_Type;
+    connType.tp_base = noticeType.tp_base = queryType.tp_base =
+        lazyRowType.tp_base = viewType.tp_base = poolType.tp_base =
+        multiType.tp_base = asyncQueryType.tp_base =
+        sourceType.tp_base = &PyBaseObject_Type;
 #ifdef LARGE_OBJECTS
     largeType.tp_base = &PyBaseObject_Type;
 #endif
 #else
-    connType.ob_type = noticeType.ob_type =
-        queryType.ob_type = sourceType.ob_type = &PyType_Type;
+    connType.ob_type = noticeType.ob_type = queryType.ob_type =
+        lazyRowType.ob_type = viewType.ob_type = poolType.ob_type =
+        multiType.ob_type = sourceType.ob_type = &PyType_Type;
 #ifdef LARGE_OBJECTS
     largeType.ob_type = &PyType_Type;
 #endif
@@ -1276,6 +1766,13 @@ MODULE_INIT_FUNC(_pg)
     if (PyType_Ready(&connType)
         || PyType_Ready(&noticeType)
         || PyType_Ready(&queryType)
+        || PyType_Ready(&lazyRowType)
+        || PyType_Ready(&viewType)
+#if IS_PY3
+        || PyType_Ready(&asyncQueryType)
+#endif
+        || PyType_Ready(&poolType)
+        || PyType_Ready(&multiType)
         || PyType_Ready(&sourceType)
 #ifdef LARGE_OBJECTS
         || PyType_Ready(&largeType)
@@ -1363,6 +1860,13 @@ MODULE_INIT_FUNC(_pg)
     PyDict_SetItemString(dict, "POLLING_READING", PyInt_FromLong(PGRES_POLLING_READING));
     PyDict_SetItemString(dict, "POLLING_WRITING", PyInt_FromLong(PGRES_POLLING_WRITING));
 
+#ifdef PIPELINE_MODE
+    /* Pipeline mode states */
+    PyDict_SetItemString(dict, "PIPELINE_OFF", PyInt_FromLong(PQ_PIPELINE_OFF));
+    PyDict_SetItemString(dict, "PIPELINE_ON", PyInt_FromLong(PQ_PIPELINE_ON));
+    PyDict_SetItemString(dict, "PIPELINE_ABORTED", PyInt_FromLong(PQ_PIPELINE_ABORTED));
+#endif /* PIPELINE_MODE */
+
 #ifdef LARGE_OBJECTS
     /* Create mode for large objects */
     PyDict_SetItemString(dict, "INV_READ", PyInt_FromLong(INV_READ));
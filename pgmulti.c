@@ -0,0 +1,344 @@
+/*
+ * PyGreSQL - a Python interface for the PostgreSQL database.
+ *
+ * The multi-connection object - this file is part a of the C extension
+ * module.
+ *
+ * Copyright (c) 2020 by the PyGreSQL Development Team
+ *
+ * Please see the LICENSE.TXT file for specific restrictions.
+ */
+
+/* The multi-connection object holds a group of connection objects,
+   e.g. one per shard of a partitioned database, and fans the same
+   query out to all of them.  The query is sent on every connection
+   without blocking and all sockets are then waited on together in a
+   single poll loop with the GIL released, so that one thread can keep
+   all servers busy at the same time. */
+
+/* Deallocate the multi-connection object. */
+static void
+multi_dealloc(multiObject *self)
+{
+    if (self->conns) {
+        while (self->num_conns) {
+            Py_DECREF(self->conns[--self->num_conns]);
+        }
+        PyMem_Free(self->conns);
+    }
+    PyObject_Del(self);
+}
+
+/* Wait until none of the member connections is busy any more, blocking
+   on all their sockets at once with the GIL released.  Returns 0 on
+   success and -1 on error with the exception set. */
+static int
+_multi_wait(multiObject *self)
+{
+#ifdef HAVE_POLL
+    struct pollfd *pfds;
+
+    pfds = (struct pollfd *) PyMem_Malloc(
+        (size_t) self->num_conns * sizeof(struct pollfd));
+    if (!pfds) {
+        PyErr_NoMemory(); return -1;
+    }
+#endif
+
+    for (;;) {
+        int i, pending = 0, ready;
+
+        /* consume input that has already arrived and find out which
+           of the member connections are still busy */
+        for (i = 0; i < self->num_conns; ++i) {
+            PGconn *cnx = ((connObject *) self->conns[i])->cnx;
+
+            if (!PQconsumeInput(cnx)) {
+                PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+#ifdef HAVE_POLL
+                PyMem_Free(pfds);
+#endif
+                return -1;
+            }
+            if (PQisBusy(cnx)) {
+#ifdef HAVE_POLL
+                pfds[pending].fd = PQsocket(cnx);
+                pfds[pending].events = POLLIN;
+                pfds[pending].revents = 0;
+#endif
+                ++pending;
+            }
+        }
+        if (!pending) break;
+
+        /* block on the busy sockets with the GIL released */
+        Py_BEGIN_ALLOW_THREADS
+#ifdef HAVE_POLL
+        ready = poll(pfds, (nfds_t) pending, -1);
+#else
+        {
+            fd_set rfds;
+            int sock, max_sock = -1;
+
+            FD_ZERO(&rfds);
+            for (i = 0; i < self->num_conns; ++i) {
+                PGconn *cnx = ((connObject *) self->conns[i])->cnx;
+
+                if (PQisBusy(cnx)) {
+                    sock = PQsocket(cnx);
+                    FD_SET(sock, &rfds);
+                    if (sock > max_sock) max_sock = sock;
+                }
+            }
+            ready = select(max_sock + 1, &rfds, NULL, NULL, NULL);
+        }
+#endif
+        Py_END_ALLOW_THREADS
+
+        if (ready < 0) {
+            if (errno == EINTR) {
+                /* pass KeyboardInterrupt etc. on to the caller */
+                if (PyErr_CheckSignals()) {
+#ifdef HAVE_POLL
+                    PyMem_Free(pfds);
+#endif
+                    return -1;
+                }
+                continue;
+            }
+            PyErr_SetFromErrno(PyExc_IOError);
+#ifdef HAVE_POLL
+            PyMem_Free(pfds);
+#endif
+            return -1;
+        }
+    }
+
+#ifdef HAVE_POLL
+    PyMem_Free(pfds);
+#endif
+    return 0;
+}
+
+/* Run a query on all member connections in parallel. */
+static char multi_query__doc__[] =
+"query(sql, [arg]) -- run a query on all member connections at once\n\n"
+"You must pass the SQL (string) request and you can optionally pass\n"
+"a tuple with positional parameters.  The query is sent to all member\n"
+"connections without blocking and the sockets are then waited on\n"
+"together until all servers have finished.  The list of the\n"
+"per-connection query objects is returned; their results are fetched\n"
+"lazily when they are accessed, like for queries sent with\n"
+"send_query().\n";
+
+static PyObject *
+multi_query(multiObject *self, PyObject *args)
+{
+    PyObject *queries;
+    int i;
+
+    if (!(queries = PyList_New(self->num_conns))) {
+        return NULL;
+    }
+
+    /* scatter the query to all member connections */
+    for (i = 0; i < self->num_conns; ++i) {
+        PyObject *query = _conn_query(
+            (connObject *) self->conns[i], args, 0, 1, 0, 0);
+
+        if (!query) {
+            Py_DECREF(queries);
+            return NULL;
+        }
+        PyList_SET_ITEM(queries, i, query);
+    }
+
+    /* wait until all servers have sent their results */
+    if (_multi_wait(self)) {
+        Py_DECREF(queries);
+        return NULL;
+    }
+
+    return queries;
+}
+
+/* Send a query to all member connections without waiting. */
+static char multi_send_query__doc__[] =
+"send_query(sql, [arg]) -- send a query to all member connections\n\n"
+"Works like the query() method, but does not wait for the servers to\n"
+"finish; accessing the results of the returned query objects will\n"
+"block on the individual connections.\n";
+
+static PyObject *
+multi_send_query(multiObject *self, PyObject *args)
+{
+    PyObject *queries;
+    int i;
+
+    if (!(queries = PyList_New(self->num_conns))) {
+        return NULL;
+    }
+
+    for (i = 0; i < self->num_conns; ++i) {
+        PyObject *query = _conn_query(
+            (connObject *) self->conns[i], args, 0, 1, 0, 0);
+
+        if (!query) {
+            Py_DECREF(queries);
+            return NULL;
+        }
+        PyList_SET_ITEM(queries, i, query);
+    }
+
+    return queries;
+}
+
+/* Return the number of member connections. */
+static Py_ssize_t
+multi_len(multiObject *self)
+{
+    return (Py_ssize_t) self->num_conns;
+}
+
+/* Return one of the member connections. */
+static PyObject *
+multi_getitem(multiObject *self, Py_ssize_t i)
+{
+    PyObject *conn;
+
+    if (i < 0 || i >= (Py_ssize_t) self->num_conns) {
+        PyErr_SetString(PyExc_IndexError, "Connection index out of range");
+        return NULL;
+    }
+    conn = self->conns[i];
+    Py_INCREF(conn);
+    return conn;
+}
+
+/* Multi-connection sequence methods */
+static PySequenceMethods multi_sequence_methods = {
+    (lenfunc) multi_len,             /* sq_length */
+    0,                               /* sq_concat */
+    0,                               /* sq_repeat */
+    (ssizeargfunc) multi_getitem,    /* sq_item */
+};
+
+/* Multi-connection object methods */
+static struct PyMethodDef multi_methods[] = {
+    {"query", (PyCFunction) multi_query,
+        METH_VARARGS, multi_query__doc__},
+    {"send_query", (PyCFunction) multi_send_query,
+        METH_VARARGS, multi_send_query__doc__},
+    {NULL, NULL}
+};
+
+static char multi__doc__[] = "PyGreSQL multi-connection";
+
+/* Multi-connection type definition */
+static PyTypeObject multiType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pg.MultiConnection",            /* tp_name */
+    sizeof(multiObject),             /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    /* methods */
+    (destructor) multi_dealloc,      /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    0,                               /* tp_as_number */
+    &multi_sequence_methods,         /* tp_as_sequence */
+    0,                               /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    0,                               /* tp_str */
+    PyObject_GenericGetAttr,         /* tp_getattro */
+    0,                               /* tp_setattro */
+    0,                               /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,              /* tp_flags */
+    multi__doc__,                    /* tp_doc */
+    0,                               /* tp_traverse */
+    0,                               /* tp_clear */
+    0,                               /* tp_richcompare */
+    0,                               /* tp_weaklistoffset */
+    0,                               /* tp_iter */
+    0,                               /* tp_iternext */
+    multi_methods,                   /* tp_methods */
+};
+
+/* Create a multi-connection object. */
+static char pg_multiconnection__doc__[] =
+"multiconnection(conn, ...) -- group connections for scattered queries\n\n"
+"The given connection objects, which can also be passed as one\n"
+"sequence, are combined into a MultiConnection object whose query()\n"
+"method runs the same query on all member connections in parallel,\n"
+"e.g. for fanning a query out to all shards of a partitioned\n"
+"database from a single thread.\n";
+
+static PyObject *
+pg_multiconnection(PyObject *self, PyObject *args)
+{
+    multiObject *multi;
+    int nconns, i;
+
+    args = PySequence_Fast(
+        args, "Function multiconnection() expects connections as arguments");
+    if (!args) {
+        return NULL;
+    }
+    nconns = (int) PySequence_Fast_GET_SIZE(args);
+
+    /* if there's a single argument and it's a list or tuple,
+     * it contains the connections */
+    if (nconns == 1) {
+        PyObject *first_obj = PySequence_Fast_GET_ITEM(args, 0);
+
+        if (PyList_Check(first_obj) || PyTuple_Check(first_obj)) {
+            Py_DECREF(args);
+            args = PySequence_Fast(first_obj, NULL);
+            if (!args) return NULL;
+            nconns = (int) PySequence_Fast_GET_SIZE(args);
+        }
+    }
+
+    if (!nconns) {
+        Py_DECREF(args);
+        PyErr_SetString(PyExc_ValueError,
+                        "Function multiconnection() expects"
+                        " at least one connection");
+        return NULL;
+    }
+    for (i = 0; i < nconns; ++i) {
+        PyObject *conn = PySequence_Fast_GET_ITEM(args, i);
+
+        if (!is_connObject(conn) || !((connObject *) conn)->cnx) {
+            Py_DECREF(args);
+            PyErr_SetString(PyExc_TypeError,
+                            "Function multiconnection() expects"
+                            " valid connection objects");
+            return NULL;
+        }
+    }
+
+    if (!(multi = PyObject_New(multiObject, &multiType))) {
+        Py_DECREF(args);
+        return NULL;
+    }
+    multi->num_conns = 0;
+    multi->conns = (PyObject **) PyMem_Malloc(
+        (size_t) nconns * sizeof(PyObject *));
+    if (!multi->conns) {
+        Py_DECREF(multi); Py_DECREF(args);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < nconns; ++i) {
+        PyObject *conn = PySequence_Fast_GET_ITEM(args, i);
+
+        Py_INCREF(conn);
+        multi->conns[multi->num_conns++] = conn;
+    }
+
+    Py_DECREF(args);
+    return (PyObject *) multi;
+}
@@ -0,0 +1,272 @@
+/*
+ * PyGreSQL - a Python interface for the PostgreSQL database.
+ *
+ * The pool object - this file is part a of the C extension module.
+ *
+ * Copyright (c) 2020 by the PyGreSQL Development Team
+ *
+ * Please see the LICENSE.TXT file for specific restrictions.
+ */
+
+/* The pool object keeps a freelist of idle, already established
+   connections.  Since all operations on the freelist itself run under
+   the GIL and never release it, acquiring and releasing a connection
+   is a constant-time operation that needs no additional lock. */
+
+/* Create a new connection with the parameters stored in the pool. */
+static PyObject *
+_pool_connect(poolObject *self)
+{
+    return pg_connect(NULL, self->args, self->kwargs);
+}
+
+/* Check whether a pooled connection is still healthy. */
+static int
+_pool_conn_is_healthy(PyObject *conn)
+{
+    PGconn *cnx = ((connObject *) conn)->cnx;
+
+    return cnx && PQstatus(cnx) == CONNECTION_OK;
+}
+
+/* Get a connection from the pool. */
+static char pool_acquire__doc__[] =
+"acquire() -- get a healthy connection from the pool\n\n"
+"An idle connection is taken from the pool if one is available,\n"
+"otherwise a new connection is established.\n";
+
+static PyObject *
+pool_acquire(poolObject *self, PyObject *noargs)
+{
+    /* take the most recently released connection, dropping
+       connections that went bad while they were sitting idle */
+    while (self->size) {
+        PyObject *conn = self->conns[--self->size];
+
+        if (_pool_conn_is_healthy(conn)) {
+            return conn; /* ownership is passed to the caller */
+        }
+        Py_DECREF(conn);
+    }
+    /* the pool is empty, establish a new connection */
+    return _pool_connect(self);
+}
+
+/* Return a connection to the pool. */
+static char pool_release__doc__[] =
+"release(conn) -- return a connection to the pool\n\n"
+"The connection must not be used any more after it has been released.\n"
+"Unhealthy connections and connections that do not fit into the pool\n"
+"any more are closed instead of being pooled.\n";
+
+static PyObject *
+pool_release(poolObject *self, PyObject *conn)
+{
+    int pooled = 0;
+
+    if (!is_connObject(conn)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Method release() expects a connection as argument");
+        return NULL;
+    }
+
+    if (self->size < self->maxsize && _pool_conn_is_healthy(conn)) {
+        int ok = 1;
+
+        if (self->reset) {
+            /* reset the session state before the connection is handed
+               out again; this fails e.g. within an aborted transaction,
+               in which case the connection is dropped instead */
+            PGconn *cnx = ((connObject *) conn)->cnx;
+            PGresult *result;
+
+            Py_BEGIN_ALLOW_THREADS
+            result = PQexec(cnx, "DISCARD ALL");
+            ok = result && PQresultStatus(result) == PGRES_COMMAND_OK;
+            if (result) {
+                PQclear(result);
+            }
+            Py_END_ALLOW_THREADS
+            if (ok) {
+                /* the server side prepared statements are gone now */
+                _conn_stmt_cache_clear((connObject *) conn);
+            }
+        }
+        /* re-check the capacity, other threads may have released
+           connections while the session state was being reset */
+        if (ok && self->size < self->maxsize) {
+            Py_INCREF(conn);
+            self->conns[self->size++] = conn;
+            pooled = 1;
+        }
+    }
+
+    if (!pooled && ((connObject *) conn)->cnx) {
+        /* close connections that were not taken back into the pool,
+           since the caller must not use them any more anyway */
+        connObject *conn_obj = (connObject *) conn;
+
+        _conn_stmt_cache_clear(conn_obj);
+        Py_BEGIN_ALLOW_THREADS
+        PQfinish(conn_obj->cnx);
+        Py_END_ALLOW_THREADS
+        conn_obj->cnx = NULL;
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Close all idle connections in the pool. */
+static char pool_close__doc__[] =
+"close() -- close all idle connections in the pool";
+
+static PyObject *
+pool_close(poolObject *self, PyObject *noargs)
+{
+    while (self->size) {
+        Py_DECREF(self->conns[--self->size]);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Deallocate the pool object. */
+static void
+pool_dealloc(poolObject *self)
+{
+    while (self->size) {
+        Py_DECREF(self->conns[--self->size]);
+    }
+    if (self->conns) {
+        PyMem_Free(self->conns);
+    }
+    Py_XDECREF(self->kwargs);
+    Py_XDECREF(self->args);
+    PyObject_Del(self);
+}
+
+/* Return the number of idle connections in the pool. */
+static Py_ssize_t
+pool_len(poolObject *self)
+{
+    return (Py_ssize_t) self->size;
+}
+
+/* Pool sequence methods */
+static PySequenceMethods pool_sequence_methods = {
+    (lenfunc) pool_len,              /* sq_length */
+};
+
+/* Pool object methods */
+static struct PyMethodDef pool_methods[] = {
+    {"acquire", (PyCFunction) pool_acquire,
+        METH_NOARGS, pool_acquire__doc__},
+    {"release", (PyCFunction) pool_release,
+        METH_O, pool_release__doc__},
+    {"close", (PyCFunction) pool_close,
+        METH_NOARGS, pool_close__doc__},
+    {NULL, NULL}
+};
+
+static char pool__doc__[] = "PyGreSQL connection pool";
+
+/* Pool type definition */
+static PyTypeObject poolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pg.Pool",                       /* tp_name */
+    sizeof(poolObject),              /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    /* methods */
+    (destructor) pool_dealloc,       /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    0,                               /* tp_as_number */
+    &pool_sequence_methods,          /* tp_as_sequence */
+    0,                               /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    0,                               /* tp_str */
+    PyObject_GenericGetAttr,         /* tp_getattro */
+    0,                               /* tp_setattro */
+    0,                               /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,              /* tp_flags */
+    pool__doc__,                     /* tp_doc */
+    0,                               /* tp_traverse */
+    0,                               /* tp_clear */
+    0,                               /* tp_richcompare */
+    0,                               /* tp_weaklistoffset */
+    0,                               /* tp_iter */
+    0,                               /* tp_iternext */
+    pool_methods,                    /* tp_methods */
+};
+
+/* Create a connection pool. */
+static char pg_pool__doc__[] =
+"pool(size, [maxsize], [reset]) -- create a pool of database connections\n\n"
+"The pool is pre-warmed with the given number of connections that are\n"
+"established with the keyword arguments also accepted by connect().\n"
+"Up to maxsize idle connections are kept in the pool (default: size).\n"
+"Unless reset is set to False, the session state of a connection is\n"
+"reset with DISCARD ALL when it is released back into the pool.\n";
+
+static PyObject *
+pg_pool(PyObject *self, PyObject *args, PyObject *dict)
+{
+    int size, maxsize = -1, reset = 1;
+    poolObject *pool;
+
+    /* connection parameters must be passed as keyword arguments,
+       they are stored and passed on to the connect function */
+    if (!PyArg_ParseTuple(args, "i|ii", &size, &maxsize, &reset)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Function pool() expects the pool size as argument");
+        return NULL;
+    }
+    if (maxsize == -1) {
+        maxsize = size;
+    }
+    if (size < 0 || maxsize < size) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Function pool() expects 0 <= size <= maxsize");
+        return NULL;
+    }
+
+    if (!(pool = PyObject_New(poolObject, &poolType))) {
+        return NULL;
+    }
+    pool->kwargs = NULL;
+    pool->conns = NULL;
+    pool->size = 0;
+    pool->maxsize = maxsize;
+    pool->reset = reset ? 1 : 0;
+    if (!(pool->args = PyTuple_New(0))) {
+        Py_DECREF(pool); return NULL;
+    }
+    Py_XINCREF(dict);
+    pool->kwargs = dict;
+    if (maxsize) {
+        pool->conns = (PyObject **) PyMem_Malloc(
+            (size_t) maxsize * sizeof(PyObject *));
+        if (!pool->conns) {
+            Py_DECREF(pool); return PyErr_NoMemory();
+        }
+    }
+
+    /* pre-warm the pool so that the connection setup latency is
+       not paid when the connections are actually needed */
+    while (pool->size < size) {
+        PyObject *conn = _pool_connect(pool);
+
+        if (!conn) {
+            Py_DECREF(pool); return NULL;
+        }
+        pool->conns[pool->size++] = conn;
+    }
+
+    return (PyObject *) pool;
+}
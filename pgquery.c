@@ -12,6 +12,40 @@
 static void
 query_dealloc(queryObject *self)
 {
+    if (self->streaming == 1 && self->pgcnx && self->pgcnx->cnx) {
+        /* a streaming query has been abandoned before it was exhausted;
+           cancel it and drain the pending results so that the connection
+           can be used for other queries again */
+        PGcancel *cancel;
+        PGresult *result;
+        char errbuf[256];
+
+        Py_BEGIN_ALLOW_THREADS
+        if ((cancel = PQgetCancel(self->pgcnx->cnx))) {
+            PQcancel(cancel, errbuf, (int) sizeof(errbuf));
+            PQfreeCancel(cancel);
+        }
+        if (self->result) {
+            PQclear(self->result);
+            self->result = NULL;
+        }
+        while ((result = PQgetResult(self->pgcnx->cnx))) {
+            PQclear(result);
+        }
+        Py_END_ALLOW_THREADS
+    }
+
+    if (self->intern_cache) {
+        Py_ssize_t i,
+            n = (Py_ssize_t) self->num_fields * INTERN_CACHE_SLOTS;
+
+        for (i = 0; i < n; ++i) {
+            Py_XDECREF(self->intern_cache[i].value);
+        }
+        PyMem_Free(self->intern_cache);
+    }
+    _arena_release(&self->arena);
+    Py_XDECREF(self->named_row_type);
     Py_XDECREF(self->pgcnx);
     if (self->col_types) {
         PyMem_Free(self->col_types);
@@ -43,6 +77,251 @@ query_len(PyObject *self)
     return len;
 }
 
+/* Deallocate a result view object. */
+static void
+view_dealloc(viewObject *self)
+{
+    if (self->mem) {
+        PQfreemem(self->mem);
+    }
+    Py_XDECREF(self->owner);
+    PyObject_Del(self);
+}
+
+/* Fill in a buffer descriptor for the data referenced by the view. */
+static int
+view_getbuffer(viewObject *self, Py_buffer *buf, int flags)
+{
+    return PyBuffer_FillInfo(
+        buf, (PyObject *) self, self->data, self->size, 1, flags);
+}
+
+/* Return the size of the referenced data in bytes. */
+static Py_ssize_t
+view_len(viewObject *self)
+{
+    return self->size;
+}
+
+/* Copy the referenced data out into a new bytes object. */
+static char view_tobytes__doc__[] =
+"tobytes() -- return a copy of the referenced data as a bytes object";
+
+static PyObject *
+view_tobytes(viewObject *self, PyObject *noargs)
+{
+    return PyBytes_FromStringAndSize(self->data, self->size);
+}
+
+/* Result view sequence methods */
+static PySequenceMethods view_as_sequence = {
+    (lenfunc) view_len,              /* sq_length */
+};
+
+/* Result view buffer methods */
+static PyBufferProcs view_as_buffer = {
+#if IS_PY3
+    (getbufferproc) view_getbuffer,  /* bf_getbuffer */
+    0,                               /* bf_releasebuffer */
+#else
+    0,                               /* bf_getreadbuffer */
+    0,                               /* bf_getwritebuffer */
+    0,                               /* bf_getsegcount */
+    0,                               /* bf_getcharbuffer */
+    (getbufferproc) view_getbuffer,  /* bf_getbuffer */
+    0,                               /* bf_releasebuffer */
+#endif
+};
+
+/* Result view methods */
+static struct PyMethodDef view_methods[] = {
+    {"tobytes", (PyCFunction) view_tobytes,
+        METH_NOARGS, view_tobytes__doc__},
+    {NULL, NULL}
+};
+
+static char view__doc__[] = "PyGreSQL zero-copy result view";
+
+/* Result view type definition */
+static PyTypeObject viewType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pg.ResultView",                 /* tp_name */
+    sizeof(viewObject),              /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    /* methods */
+    (destructor) view_dealloc,       /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    0,                               /* tp_as_number */
+    &view_as_sequence,               /* tp_as_sequence */
+    0,                               /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    0,                               /* tp_str */
+    0,                               /* tp_getattro */
+    0,                               /* tp_setattro */
+    &view_as_buffer,                 /* tp_as_buffer */
+#if IS_PY3
+    Py_TPFLAGS_DEFAULT,              /* tp_flags */
+#else
+    Py_TPFLAGS_DEFAULT
+        | Py_TPFLAGS_HAVE_NEWBUFFER, /* tp_flags */
+#endif
+    view__doc__,                     /* tp_doc */
+    0,                               /* tp_traverse */
+    0,                               /* tp_clear */
+    0,                               /* tp_richcompare */
+    0,                               /* tp_weaklistoffset */
+    0,                               /* tp_iter */
+    0,                               /* tp_iternext */
+    view_methods,                    /* tp_methods */
+};
+
+/* Create a view on the given data, optionally owning the given memory,
+   which is freed with PQfreemem when the view is released.  The view
+   keeps the optional owner object alive as long as it exists. */
+static PyObject *
+_view_from_buffer(PyObject *owner, char *mem, char *data, Py_ssize_t size)
+{
+    viewObject *view;
+
+    if (!(view = PyObject_New(viewObject, &viewType))) {
+        if (mem) PQfreemem(mem);
+        return NULL;
+    }
+    Py_XINCREF(owner);
+    view->owner = owner;
+    view->mem = mem;
+    view->data = data;
+    view->size = size;
+    return (PyObject *) view;
+}
+
+/* Create a view on the given data, optionally owning the given memory.
+   The view holds a reference to the query that keeps the result alive. */
+static PyObject *
+_view_from_query(queryObject *self, char *mem, char *data, Py_ssize_t size)
+{
+    return _view_from_buffer((PyObject *) self, mem, data, size);
+}
+
+/* Cast the value in the given column of the current row. */
+static PyObject *
+_query_cast_in_column(queryObject *self, int column, char *s, int type)
+{
+    PyObject *obj;
+    pgArena *prev_arena = scratch_arena;
+
+    /* parse scratch for this value comes from the per-query arena;
+       the reset is skipped for re-entrant casts so that scratch held
+       by an outer cast of the same query remains valid */
+    if (!self->arena.active) _arena_reset(&self->arena);
+    ++self->arena.active;
+    scratch_arena = &self->arena;
+
+    /* binary result values are cast with the binary kernels */
+    if (PQfformat(self->result, column) != 0)
+        obj = cast_binary_value(s,
+            PQgetlength(self->result, self->current_row, column),
+            self->encoding, type, PQftype(self->result, column));
+
+    /* cast the string representation into a Python object */
+    else if (type & PYGRES_ARRAY)
+        obj = cast_array(s,
+            PQgetlength(self->result, self->current_row, column),
+            self->encoding, type, NULL, 0);
+    else if (type == PYGRES_BYTEA)
+        obj = cast_bytea_text(s);
+    else if (type == PYGRES_OTHER)
+        obj = cast_other(s,
+            PQgetlength(self->result, self->current_row, column),
+            self->encoding,
+            PQftype(self->result, column), self->pgcnx->cast_hook);
+    else if (type & PYGRES_TEXT)
+        obj = cast_sized_text(s,
+            PQgetlength(self->result, self->current_row, column),
+            self->encoding, type);
+    else
+        obj = cast_unsized_simple(s, type);
+
+    scratch_arena = prev_arena;
+    --self->arena.active;
+    return obj;
+}
+
+/* Hash cell bytes for the per-column caches of interned values. */
+static unsigned long
+_intern_hash(const char *s, Py_ssize_t size)
+{
+    unsigned long h = 2166136261UL; /* FNV-1a */
+
+    while (size--) {
+        h ^= (unsigned char) *s++; h *= 16777619UL;
+    }
+    return h;
+}
+
+/* Look up the given cell bytes in the per-column cache of interned
+   values.  Returns a new reference to the shared Python object or NULL
+   when these bytes have not been cached for this column yet. */
+static PyObject *
+_query_intern_lookup(queryObject *self, int column,
+                     char *s, Py_ssize_t size)
+{
+    internEntry *cache;
+    unsigned long h, i;
+
+    if (!self->intern_cache) return NULL;
+    h = _intern_hash(s, size);
+    cache = self->intern_cache + (Py_ssize_t) column * INTERN_CACHE_SLOTS;
+    for (i = 0; i < INTERN_CACHE_PROBES; ++i) {
+        internEntry *entry = cache + ((h + i) & (INTERN_CACHE_SLOTS - 1));
+
+        if (!entry->value) return NULL;
+        if (entry->size == size && !memcmp(entry->data, s, (size_t) size)) {
+            Py_INCREF(entry->value);
+            return entry->value;
+        }
+    }
+    return NULL;
+}
+
+/* Remember the Python object created for the given cell bytes in the
+   per-column cache, so that repeated values share one object.  The data
+   pointer references the result storage, which outlives the cache. */
+static void
+_query_intern_store(queryObject *self, int column,
+                    char *s, Py_ssize_t size, PyObject *value)
+{
+    internEntry *cache, *entry;
+    unsigned long h, i;
+
+    if (!self->intern_cache) {
+        size_t n = (size_t) self->num_fields * INTERN_CACHE_SLOTS;
+
+        self->intern_cache =
+            (internEntry *) PyMem_Malloc(n * sizeof(internEntry));
+        if (!self->intern_cache) return; /* simply do not cache then */
+        memset(self->intern_cache, 0, n * sizeof(internEntry));
+    }
+    h = _intern_hash(s, size);
+    cache = self->intern_cache + (Py_ssize_t) column * INTERN_CACHE_SLOTS;
+    entry = cache + (h & (INTERN_CACHE_SLOTS - 1));
+    for (i = 0; i < INTERN_CACHE_PROBES; ++i) {
+        internEntry *slot = cache + ((h + i) & (INTERN_CACHE_SLOTS - 1));
+
+        if (!slot->value) {
+            entry = slot; break;
+        }
+    }
+    Py_XDECREF(entry->value); /* evict the old entry if necessary */
+    entry->data = s; entry->size = size;
+    Py_INCREF(value); entry->value = value;
+}
+
 /* Return the value in the given column of the current row. */
 static PyObject *
 _query_value_in_column(queryObject *self, int column)
@@ -61,23 +340,53 @@ _query_value_in_column(queryObject *self, int column)
     /* get the PyGreSQL type of the column */
     type = self->col_types[column];
 
-    /* cast the string representation into a Python object */
-    if (type & PYGRES_ARRAY)
-        return cast_array(s,
-            PQgetlength(self->result, self->current_row, column),
-            self->encoding, type, NULL, 0);
-    if (type == PYGRES_BYTEA)
-        return cast_bytea_text(s);
-    if (type == PYGRES_OTHER)
-        return cast_other(s,
-            PQgetlength(self->result, self->current_row, column),
-            self->encoding,
-            PQftype(self->result, column), self->pgcnx->cast_hook);
-    if (type & PYGRES_TEXT)
-        return cast_sized_text(s,
-            PQgetlength(self->result, self->current_row, column),
-            self->encoding, type);
-    return cast_unsized_simple(s, type);
+    self->pgcnx->stats.bytes += (unsigned PY_LONG_LONG)
+        PQgetlength(self->result, self->current_row, column);
+
+    /* in zero-copy mode, text and bytea values are returned as views
+       referencing the result storage instead of being copied out;
+       streamed and asynchronous results are replaced during iteration,
+       so these keep using the copying casts */
+    if (zerocopy && !self->async && !self->streaming
+        && (type == PYGRES_TEXT || type == PYGRES_BYTEA))
+    {
+        if (type == PYGRES_BYTEA && PQfformat(self->result, column) == 0) {
+            /* text format bytea must still be unescaped once,
+               the view then owns the unescaped buffer */
+            size_t size;
+            char *tmp = (char *) PQunescapeBytea(
+                (unsigned char *) s, &size);
+
+            if (!tmp) return PyErr_NoMemory();
+            return _view_from_query(self, tmp, tmp, (Py_ssize_t) size);
+        }
+        return _view_from_query(self, NULL, s, (Py_ssize_t)
+            PQgetlength(self->result, self->current_row, column));
+    }
+
+    /* with interning enabled, repeated cell values are returned as
+       shared references from a per-column cache; only immutable result
+       types may be shared, and streamed and asynchronous results are
+       excluded because their storage is replaced during iteration */
+    if (interning && !self->async && !self->streaming
+        && !(type & PYGRES_ARRAY)
+        && type != PYGRES_JSON && type != PYGRES_OTHER)
+    {
+        Py_ssize_t size = (Py_ssize_t)
+            PQgetlength(self->result, self->current_row, column);
+
+        if (size <= INTERN_MAX_SIZE) {
+            PyObject *obj = _query_intern_lookup(self, column, s, size);
+
+            if (!obj) {
+                obj = _query_cast_in_column(self, column, s, type);
+                if (obj) _query_intern_store(self, column, s, size, obj);
+            }
+            return obj;
+        }
+    }
+
+    return _query_cast_in_column(self, column, s, type);
 }
 
 /* Return the current row as a tuple. */
@@ -85,6 +394,7 @@ static PyObject *
 _query_row_as_tuple(queryObject *self)
 {
     PyObject *row_tuple = NULL;
+    double t0 = _monotime();
     int j;
 
     if (!(row_tuple = PyTuple_New(self->num_fields))) {
@@ -99,9 +409,177 @@ _query_row_as_tuple(queryObject *self)
         PyTuple_SET_ITEM(row_tuple, j, val);
     }
 
+    self->pgcnx->stats.cast_time += _monotime() - t0;
+    ++self->pgcnx->stats.rows;
     return row_tuple;
 }
 
+/* Deallocate the lazy row object. */
+static void
+lazy_row_dealloc(lazyRowObject *self)
+{
+    if (self->values) {
+        int j;
+
+        for (j = 0; j < self->query->num_fields; ++j) {
+            Py_XDECREF(self->values[j]);
+        }
+        PyMem_Free(self->values);
+    }
+    Py_XDECREF(self->query);
+    PyObject_Del(self);
+}
+
+/* Get the value in the given column of the lazy row.
+   The value is cast on first access and memoized for repeated access. */
+static PyObject *
+_lazy_row_value(lazyRowObject *self, int col)
+{
+    queryObject *q = self->query;
+    PyObject *value;
+
+    if (col < 0 || col >= q->num_fields) {
+        PyErr_SetString(PyExc_IndexError, "Invalid column index");
+        return NULL;
+    }
+
+    if (!self->values) {
+        size_t size = (size_t) q->num_fields * sizeof(PyObject *);
+
+        self->values = (PyObject **) PyMem_Malloc(size);
+        if (!self->values) return PyErr_NoMemory();
+        memset(self->values, 0, size);
+    }
+
+    if (!(value = self->values[col])) {
+        int saved_row = q->current_row;
+
+        q->current_row = self->row;
+        value = _query_value_in_column(q, col);
+        q->current_row = saved_row;
+        if (!value) return NULL;
+        self->values[col] = value;
+    }
+    Py_INCREF(value);
+    return value;
+}
+
+/* Return the number of fields in the lazy row. */
+static Py_ssize_t
+lazy_row_len(lazyRowObject *self)
+{
+    return (Py_ssize_t) self->query->num_fields;
+}
+
+/* Get a value from the lazy row by column index or field name. */
+static PyObject *
+lazy_row_subscript(lazyRowObject *self, PyObject *key)
+{
+    int col;
+
+    if (PyInt_Check(key)) {
+        col = (int) PyInt_AsLong(key);
+        if (col < 0) col += self->query->num_fields;
+    }
+    else if (PyBytes_Check(key)) {
+        col = PQfnumber(self->query->result, PyBytes_AsString(key));
+        if (col < 0) {
+            PyErr_SetString(PyExc_KeyError, "Unknown field");
+            return NULL;
+        }
+    }
+    else if (PyStr_Check(key)) {
+        PyObject *tmp = get_encoded_string(key, self->query->encoding);
+
+        if (!tmp) return NULL; /* pass the UnicodeEncodeError */
+        col = PQfnumber(self->query->result, PyBytes_AsString(tmp));
+        Py_DECREF(tmp);
+        if (col < 0) {
+            PyErr_SetString(PyExc_KeyError, "Unknown field");
+            return NULL;
+        }
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError,
+                        "Field should be given as column number or name");
+        return NULL;
+    }
+
+    return _lazy_row_value(self, col);
+}
+
+/* Get lazy row attributes, giving the fields of the row precedence. */
+static PyObject *
+lazy_row_getattr(lazyRowObject *self, PyObject *nameobj)
+{
+    const char *name = PyStr_AsString(nameobj);
+    int col = name ? PQfnumber(self->query->result, name) : -1;
+
+    if (col >= 0) {
+        return _lazy_row_value(self, col);
+    }
+    PyErr_Clear();
+    return PyObject_GenericGetAttr((PyObject *) self, nameobj);
+}
+
+/* Return the fully materialized lazy row as a string. */
+static PyObject *
+lazy_row_str(lazyRowObject *self)
+{
+    PyObject *row_tuple, *str;
+    int j;
+
+    if (!(row_tuple = PyTuple_New(self->query->num_fields))) {
+        return NULL;
+    }
+    for (j = 0; j < self->query->num_fields; ++j) {
+        PyObject *value = _lazy_row_value(self, j);
+
+        if (!value) {
+            Py_DECREF(row_tuple); return NULL;
+        }
+        PyTuple_SET_ITEM(row_tuple, j, value);
+    }
+    str = PyObject_Str(row_tuple);
+    Py_DECREF(row_tuple);
+    return str;
+}
+
+/* Lazy row mapping methods */
+static PyMappingMethods lazy_row_as_mapping = {
+    (lenfunc) lazy_row_len,          /* mp_length */
+    (binaryfunc) lazy_row_subscript, /* mp_subscript */
+    0,                               /* mp_ass_subscript */
+};
+
+static char lazy_row__doc__[] = "PyGreSQL lazy result row";
+
+/* Lazy row type definition */
+static PyTypeObject lazyRowType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pg.LazyRow",                    /* tp_name */
+    sizeof(lazyRowObject),           /* tp_basicsize */
+    0,                               /* tp_itemsize */
+    /* methods */
+    (destructor) lazy_row_dealloc,   /* tp_dealloc */
+    0,                               /* tp_print */
+    0,                               /* tp_getattr */
+    0,                               /* tp_setattr */
+    0,                               /* tp_compare */
+    0,                               /* tp_repr */
+    0,                               /* tp_as_number */
+    0,                               /* tp_as_sequence */
+    &lazy_row_as_mapping,            /* tp_as_mapping */
+    0,                               /* tp_hash */
+    0,                               /* tp_call */
+    (reprfunc) lazy_row_str,         /* tp_str */
+    (getattrofunc) lazy_row_getattr, /* tp_getattro */
+    0,                               /* tp_setattro */
+    0,                               /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,              /* tp_flags */
+    lazy_row__doc__,                 /* tp_doc */
+};
+
 /* Fetch the result if this is an asynchronous query and it has not yet
    been fetched in this round-trip. Also mark whether the result should
    be kept for this round-trip (e.g. to be used in an iterator).
@@ -145,7 +623,23 @@ _get_async_result(queryObject *self, int keep) {
             return Py_None;
         }
 
-        if ((status = PQresultStatus(self->result)) != PGRES_TUPLES_OK) {
+        status = PQresultStatus(self->result);
+        if (self->streaming && status == PGRES_TUPLES_OK) {
+            /* a zero-row result marks the end of the streamed result set,
+               after which the trailing NULL result must be consumed so
+               that the connection does not stay busy */
+            PGresult *result;
+
+            self->streaming = 2;
+            Py_BEGIN_ALLOW_THREADS
+            while ((result = PQgetResult(self->pgcnx->cnx))) {
+                PQclear(result);
+            }
+            Py_END_ALLOW_THREADS
+        }
+        if (status != PGRES_TUPLES_OK &&
+            !(self->streaming == 1 && status == PGRES_SINGLE_TUPLE))
+        {
             PyObject* result = _conn_non_query_result(
                 status, self->result, self->pgcnx->cnx);
             self->result = NULL; /* since this has been already cleared */
@@ -230,9 +724,64 @@ query_next(queryObject *self, PyObject *noargs)
 {
     PyObject *row_tuple = NULL;
 
-    if (self->current_row >= self->max_row) {
-        PyErr_SetNone(PyExc_StopIteration);
-        return NULL;
+    while (self->current_row >= self->max_row) {
+        int status;
+
+        if (self->streaming != 1 || !self->pgcnx) {
+            PyErr_SetNone(PyExc_StopIteration);
+            return NULL;
+        }
+
+        /* fetch the next streamed portion of the result set */
+        Py_BEGIN_ALLOW_THREADS
+        if (self->result) {
+            PQclear(self->result);
+        }
+        self->result = PQgetResult(self->pgcnx->cnx);
+        Py_END_ALLOW_THREADS
+        if (!self->result) {
+            self->streaming = 2;
+            PyErr_SetNone(PyExc_StopIteration);
+            return NULL;
+        }
+
+        status = PQresultStatus(self->result);
+        if (status == PGRES_SINGLE_TUPLE) {
+            self->current_row = 0;
+            self->max_row = PQntuples(self->result);
+        }
+        else if (status == PGRES_TUPLES_OK) {
+            /* a zero-row result marks the end of the streamed result set;
+               consume the trailing NULL result as well, so that the
+               connection leaves the busy state and can be used again */
+            PGresult *result;
+
+            self->streaming = 2;
+            self->current_row = self->max_row = 0;
+            Py_BEGIN_ALLOW_THREADS
+            while ((result = PQgetResult(self->pgcnx->cnx))) {
+                PQclear(result);
+            }
+            Py_END_ALLOW_THREADS
+        }
+        else {
+            PyObject *result = _conn_non_query_result(
+                status, self->result, self->pgcnx->cnx);
+
+            self->result = NULL; /* since this has been already cleared */
+            self->streaming = 2;
+            if (!result) {
+                /* Raise an error. We need to call PQgetResult() to clear
+                   the connection state. */
+                while ((self->result = PQgetResult(self->pgcnx->cnx))) {
+                    PQclear(self->result);
+                }
+                return NULL;
+            }
+            Py_DECREF(result);
+            PyErr_SetNone(PyExc_StopIteration);
+            return NULL;
+        }
     }
 
     row_tuple = _query_row_as_tuple(self);
@@ -498,6 +1047,233 @@ query_getresult(queryObject *self, PyObject *noargs)
     return result_list;
 }
 
+/* Retrieve the last query result as a list of lazy rows. */
+static char query_lazyresult__doc__[] =
+"lazyresult() -- Get the result of a query as lazy rows\n\n"
+"The result is returned as a list of lazy row objects which cast the\n"
+"value of a column only when it is actually accessed, by index, field\n"
+"name or attribute, and memoize it for repeated access.  This avoids\n"
+"the cast overhead for columns that are never used.  Note that the\n"
+"values must be accessed before the query is used to fetch another\n"
+"result, since the lazy rows reference the current result.\n";
+
+static PyObject *
+query_lazyresult(queryObject *self, PyObject *noargs)
+{
+    PyObject *result_list;
+    int i;
+
+    if ((result_list = _get_async_result(self, 0)) == (PyObject *)self) {
+
+        if (!(result_list = PyList_New(self->max_row))) {
+            return NULL;
+        }
+
+        for (i = 0; i < self->max_row; ++i) {
+            lazyRowObject *row = PyObject_New(lazyRowObject, &lazyRowType);
+
+            if (!row) {
+                Py_DECREF(result_list); return NULL;
+            }
+            Py_INCREF(self);
+            row->query = self;
+            row->row = i;
+            row->values = NULL;
+            PyList_SET_ITEM(result_list, i, (PyObject *) row);
+        }
+    }
+
+    return result_list;
+}
+
+/* Extract one column of the query result into a contiguous typed array.
+   The values are stored as C int64, float64 or uint8 in a bytearray
+   that can be wrapped without copying via the buffer protocol; null
+   values are stored as zero and flagged in the nulls array. */
+static PyObject *
+_query_column_as_array(queryObject *self, int col, char typecode,
+                       char *nulls)
+{
+    PyObject *values;
+    Py_ssize_t itemsize = typecode == 'B' ? 1 : 8;
+    int binary = PQfformat(self->result, col) != 0;
+    char *vp;
+    int i;
+
+    if (!(values = PyByteArray_FromStringAndSize(
+        NULL, (Py_ssize_t) self->max_row * itemsize)))
+    {
+        return NULL;
+    }
+    vp = PyByteArray_AS_STRING(values);
+
+    for (i = 0; i < self->max_row; ++i, vp += itemsize) {
+        char *s;
+
+        if (PQgetisnull(self->result, i, col)) {
+            nulls[i] = 1; memset(vp, 0, (size_t) itemsize);
+            continue;
+        }
+        nulls[i] = 0;
+        s = PQgetvalue(self->result, i, col);
+        switch (typecode) {
+            case 'q':
+            {
+                long long value;
+
+                if (binary) {
+                    switch (PQgetlength(self->result, i, col)) {
+                        case 2:
+                            value = read_binary_int16(s); break;
+                        case 4:
+                            value = read_binary_int32(s); break;
+                        default:
+                            value = read_binary_int64(s);
+                    }
+                }
+                else {
+                    value = strtoll(s, NULL, 10);
+                }
+                memcpy(vp, &value, sizeof(value));
+                break;
+            }
+            case 'd':
+            {
+                double value;
+
+                if (binary) {
+                    if (PQgetlength(self->result, i, col) == 4) {
+                        union { int i; float f; } u;
+
+                        u.i = (int) read_binary_int32(s);
+                        value = (double) u.f;
+                    }
+                    else {
+                        union { long long i; double d; } u;
+
+                        u.i = read_binary_int64(s);
+                        value = u.d;
+                    }
+                }
+                else {
+                    value = strtod(s, NULL);
+                }
+                memcpy(vp, &value, sizeof(value));
+                break;
+            }
+            default: /* 'B' */
+                *vp = (char) (binary ? *s : *s == 't');
+        }
+    }
+
+    return values;
+}
+
+/* Retrieve the last query result in columnar form. */
+static char query_getcolumns__doc__[] =
+"getcolumns() -- Get the result of a query as contiguous columns\n\n"
+"The result is returned as a dictionary mapping the field names to\n"
+"triples (typecode, values, nulls).  For integer, float and boolean\n"
+"columns, values is a bytearray holding the column values as a packed\n"
+"array of the C type indicated by the typecode ('q', 'd' or 'B'),\n"
+"which can be wrapped without copying, e.g. with numpy.frombuffer();\n"
+"for columns of other types, the typecode is None and values is a\n"
+"list of Python objects.  nulls is a bytearray with one byte per row\n"
+"that is set to 1 where the value in that row is null.\n";
+
+static PyObject *
+query_getcolumns(queryObject *self, PyObject *noargs)
+{
+    PyObject *result_dict;
+    int j;
+
+    if ((result_dict = _get_async_result(self, 0)) != (PyObject *)self) {
+        return result_dict;
+    }
+
+    if (!(result_dict = PyDict_New())) {
+        return NULL;
+    }
+
+    for (j = 0; j < self->num_fields; ++j) {
+        PyObject *values = NULL, *nulls, *typecode, *column;
+        int type = self->col_types[j];
+        char tc = 0;
+        char *np;
+
+        if (!(type & PYGRES_ARRAY)) {
+            switch (type) {
+                case PYGRES_INT:
+                case PYGRES_LONG:
+                    tc = 'q'; break;
+                case PYGRES_FLOAT:
+                    tc = 'd'; break;
+                case PYGRES_BOOL:
+                    if (!bool_as_text) tc = 'B';
+                    break;
+            }
+        }
+
+        if (!(nulls = PyByteArray_FromStringAndSize(
+            NULL, (Py_ssize_t) self->max_row)))
+        {
+            Py_DECREF(result_dict); return NULL;
+        }
+        np = PyByteArray_AS_STRING(nulls);
+
+        if (tc) {
+            values = _query_column_as_array(self, j, tc, np);
+        }
+        else { /* no typed array possible, build a list of objects */
+            if ((values = PyList_New(self->max_row))) {
+                int i;
+
+                for (i = 0; i < self->max_row; ++i) {
+                    PyObject *val;
+
+                    if (PQgetisnull(self->result, i, j)) {
+                        np[i] = 1;
+                        Py_INCREF(Py_None);
+                        PyList_SET_ITEM(values, i, Py_None);
+                        continue;
+                    }
+                    np[i] = 0;
+                    self->current_row = i;
+                    if (!(val = _query_value_in_column(self, j))) {
+                        Py_DECREF(values); values = NULL; break;
+                    }
+                    PyList_SET_ITEM(values, i, val);
+                }
+            }
+        }
+        if (!values) {
+            Py_DECREF(nulls); Py_DECREF(result_dict); return NULL;
+        }
+
+        typecode = tc ? PyStr_FromStringAndSize(&tc, 1) : Py_None;
+        if (!tc) Py_INCREF(typecode);
+
+        column = PyTuple_New(3);
+        if (!column) {
+            Py_DECREF(typecode); Py_DECREF(values); Py_DECREF(nulls);
+            Py_DECREF(result_dict); return NULL;
+        }
+        PyTuple_SET_ITEM(column, 0, typecode);
+        PyTuple_SET_ITEM(column, 1, values);
+        PyTuple_SET_ITEM(column, 2, nulls);
+
+        if (PyDict_SetItemString(
+            result_dict, PQfname(self->result, j), column))
+        {
+            Py_DECREF(column); Py_DECREF(result_dict); return NULL;
+        }
+        Py_DECREF(column);
+    }
+
+    self->current_row = 0;
+    return result_dict;
+}
+
 /* Return the current row as a dict. */
 static PyObject *
 _query_row_as_dict(queryObject *self)
@@ -648,6 +1424,192 @@ query_dictiter(queryObject *self, PyObject *noargs)
     return PyObject_CallFunction(dictiter, "(O)", self);
 }
 
+#if IS_PY3
+/* Named rows are built natively as struct sequences, which provide
+   attribute access like named tuples but are much cheaper to create.
+   The row type is built once per query object from the field names. */
+
+/* The memory block holding the field names is freed with the row type. */
+static void
+_named_row_fields_free(PyObject *capsule)
+{
+    PyMem_Free(PyCapsule_GetPointer(capsule, NULL));
+}
+
+/* Decode the name of the given result field and append it to the list,
+   applying the same renaming rules for invalid, duplicate or keyword
+   names that collections.namedtuple() applies with rename=True. */
+static int
+_query_append_field_name(queryObject *self, int col, PyObject *names)
+{
+    static PyObject *iskeyword = NULL;
+    char *name = PQfname(self->result, col);
+    PyObject *nameobj;
+    int valid, ret;
+
+    nameobj = get_decoded_string(
+        name, (Py_ssize_t) strlen(name), self->encoding);
+    if (!nameobj) return -1;
+    valid = PyUnicode_IsIdentifier(nameobj);
+    if (valid < 0) {
+        Py_DECREF(nameobj); return -1;
+    }
+    if (valid && PyUnicode_ReadChar(nameobj, 0) == '_') {
+        valid = 0; /* names with a leading underscore are renamed */
+    }
+    if (valid) { /* keywords are renamed as well */
+        PyObject *res;
+
+        if (!iskeyword) {
+            PyObject *keyword = PyImport_ImportModule("keyword");
+
+            if (!keyword) {
+                Py_DECREF(nameobj); return -1;
+            }
+            iskeyword = PyObject_GetAttrString(keyword, "iskeyword");
+            Py_DECREF(keyword);
+            if (!iskeyword) {
+                Py_DECREF(nameobj); return -1;
+            }
+        }
+        res = PyObject_CallFunctionObjArgs(iskeyword, nameobj, NULL);
+        if (!res) {
+            Py_DECREF(nameobj); return -1;
+        }
+        if (PyObject_IsTrue(res)) valid = 0;
+        Py_DECREF(res);
+    }
+    if (valid) { /* duplicate names are renamed, too */
+        int dup = PySequence_Contains(names, nameobj);
+
+        if (dup < 0) {
+            Py_DECREF(nameobj); return -1;
+        }
+        if (dup) valid = 0;
+    }
+    if (!valid) {
+        Py_DECREF(nameobj);
+        if (!(nameobj = PyUnicode_FromFormat("_%d", col))) return -1;
+    }
+    ret = PyList_Append(names, nameobj);
+    Py_DECREF(nameobj);
+    return ret;
+}
+
+/* Build the struct sequence type for the named rows of this query. */
+static int
+_query_build_named_row_type(queryObject *self)
+{
+    PyStructSequence_Desc desc;
+    PyStructSequence_Field *fields = NULL;
+    PyObject *names = NULL, *capsule = NULL, *fields_tuple = NULL;
+    PyTypeObject *row_type;
+    Py_ssize_t mem_size;
+    char *p;
+    int j, n = self->num_fields;
+
+    if (self->named_row_type) return 0; /* already built */
+
+    if (!(names = PyList_New(0))) return -1;
+    for (j = 0; j < n; ++j) {
+        if (_query_append_field_name(self, j, names)) goto error;
+    }
+
+    /* copy the names into one block that is kept alive by the type,
+       with the field descriptors in front of the name strings */
+    mem_size = ((Py_ssize_t) n + 1)
+        * (Py_ssize_t) sizeof(PyStructSequence_Field);
+    for (j = 0; j < n; ++j) {
+        Py_ssize_t size;
+
+        if (!PyUnicode_AsUTF8AndSize(PyList_GET_ITEM(names, j), &size))
+            goto error;
+        mem_size += size + 1;
+    }
+    if (!(fields = (PyStructSequence_Field *) PyMem_Malloc(
+        (size_t) mem_size)))
+    {
+        PyErr_NoMemory(); goto error;
+    }
+    p = (char *) (fields + n + 1);
+    for (j = 0; j < n; ++j) {
+        Py_ssize_t size;
+        const char *name = PyUnicode_AsUTF8AndSize(
+            PyList_GET_ITEM(names, j), &size);
+
+        if (!name) goto error;
+        memcpy(p, name, (size_t) size + 1);
+        fields[j].name = p;
+        fields[j].doc = NULL;
+        p += size + 1;
+    }
+    fields[n].name = NULL;
+    fields[n].doc = NULL;
+    if (!(capsule = PyCapsule_New(fields, NULL, _named_row_fields_free)))
+        goto error;
+    fields = NULL; /* now owned by the capsule */
+
+    desc.name = "pg.Row";
+    desc.doc = "PyGreSQL named result row";
+    desc.fields = (PyStructSequence_Field *) PyCapsule_GetPointer(
+        capsule, NULL);
+    desc.n_in_sequence = n;
+    if (!(row_type = PyStructSequence_NewType(&desc))) goto error;
+    self->named_row_type = (PyObject *) row_type;
+
+    /* provide the _fields attribute known from named tuples and keep
+       the name strings alive as long as the row type exists */
+    if (!(fields_tuple = PyList_AsTuple(names))
+        || PyObject_SetAttrString(
+            (PyObject *) row_type, "_fields", fields_tuple)
+        || PyObject_SetAttrString(
+            (PyObject *) row_type, "_pg_field_names", capsule))
+    {
+        Py_CLEAR(self->named_row_type);
+        goto error;
+    }
+    Py_DECREF(fields_tuple);
+    Py_DECREF(capsule);
+    Py_DECREF(names);
+    return 0;
+
+error:
+    Py_XDECREF(fields_tuple);
+    Py_XDECREF(capsule);
+    Py_XDECREF(names);
+    if (fields) PyMem_Free(fields);
+    return -1;
+}
+
+/* Return the current row as a named row (struct sequence). */
+static PyObject *
+_query_row_as_named(queryObject *self)
+{
+    PyObject *row;
+    double t0 = _monotime();
+    int j;
+
+    if (_query_build_named_row_type(self)) return NULL;
+
+    if (!(row = PyStructSequence_New(
+        (PyTypeObject *) self->named_row_type)))
+    {
+        return NULL;
+    }
+    for (j = 0; j < self->num_fields; ++j) {
+        PyObject *val = _query_value_in_column(self, j);
+
+        if (!val) {
+            Py_DECREF(row); return NULL;
+        }
+        PyStructSequence_SET_ITEM(row, j, val);
+    }
+    self->pgcnx->stats.cast_time += _monotime() - t0;
+    ++self->pgcnx->stats.rows;
+    return row;
+}
+#endif /* IS_PY3 */
+
 /* Retrieve one row from the result as a named tuple. */
 static char query_onenamed__doc__[] =
 "onenamed() -- Get one row from the result of a query\n\n"
@@ -660,9 +1622,11 @@ query_onenamed(queryObject *self, PyObject *noargs)
 {
     PyObject *res;
 
+#if !IS_PY3
     if (!namednext) {
         return query_one(self, noargs);
     }
+#endif
 
     if ((res = _get_async_result(self, 1)) != (PyObject *)self)
         return res;
@@ -671,7 +1635,13 @@ query_onenamed(queryObject *self, PyObject *noargs)
         Py_INCREF(Py_None); return Py_None;
     }
 
+#if IS_PY3
+    res = _query_row_as_named(self);
+    if (res) ++self->current_row;
+    return res;
+#else
     return PyObject_CallFunction(namednext, "(O)", self);
+#endif
 }
 
 /* Retrieve the single row from the result as a tuple. */
@@ -687,9 +1657,11 @@ query_singlenamed(queryObject *self, PyObject *noargs)
 {
     PyObject *res;
 
+#if !IS_PY3
     if (!namednext) {
         return query_single(self, noargs);
     }
+#endif
 
     if ((res = _get_async_result(self, 1)) != (PyObject *)self)
         return res;
@@ -703,7 +1675,13 @@ query_singlenamed(queryObject *self, PyObject *noargs)
     }
 
     self->current_row = 0;
+#if IS_PY3
+    res = _query_row_as_named(self);
+    if (res) ++self->current_row;
+    return res;
+#else
     return PyObject_CallFunction(namednext, "(O)", self);
+#endif
 }
 
 /* Retrieve last result as list of named tuples. */
@@ -715,6 +1693,29 @@ static char query_namedresult__doc__[] =
 static PyObject *
 query_namedresult(queryObject *self, PyObject *noargs)
 {
+#if IS_PY3
+    PyObject *res_list;
+    int i;
+
+    if ((res_list = _get_async_result(self, 0)) == (PyObject *)self) {
+
+        if (!(res_list = PyList_New(self->max_row))) {
+            return NULL;
+        }
+
+        for (i = self->current_row = 0; i < self->max_row; ++i) {
+            PyObject *row = _query_row_as_named(self);
+
+            if (!row) {
+                Py_DECREF(res_list); return NULL;
+            }
+            ++self->current_row;
+            PyList_SET_ITEM(res_list, i, row);
+        }
+    }
+
+    return res_list;
+#else
     PyObject *res, *res_list;
 
     if (!namediter) {
@@ -731,6 +1732,7 @@ query_namedresult(queryObject *self, PyObject *noargs)
     }
 
     return res_list;
+#endif
 }
 
 /* Retrieve last result as iterator of named tuples. */
@@ -742,6 +1744,15 @@ static char query_namediter__doc__[] =
 static PyObject *
 query_namediter(queryObject *self, PyObject *noargs)
 {
+#if IS_PY3
+    PyObject *res_list, *res_iter;
+
+    res_list = query_namedresult(self, noargs);
+    if (!res_list || !PyList_Check(res_list)) return res_list;
+    res_iter = PyObject_GetIter(res_list);
+    Py_DECREF(res_list);
+    return res_iter;
+#else
     PyObject *res, *res_iter;
 
     if (!namediter) {
@@ -758,6 +1769,7 @@ query_namediter(queryObject *self, PyObject *noargs)
     }
 
     return res_iter;
+#endif
 }
 
 /* Retrieve the last query result as a list of scalar values. */
@@ -906,6 +1918,10 @@ static PySequenceMethods query_sequence_methods = {
 static struct PyMethodDef query_methods[] = {
     {"getresult", (PyCFunction) query_getresult,
         METH_NOARGS, query_getresult__doc__},
+    {"getcolumns", (PyCFunction) query_getcolumns,
+        METH_NOARGS, query_getcolumns__doc__},
+    {"lazyresult", (PyCFunction) query_lazyresult,
+        METH_NOARGS, query_lazyresult__doc__},
     {"dictresult", (PyCFunction) query_dictresult,
         METH_NOARGS, query_dictresult__doc__},
     {"dictiter", (PyCFunction) query_dictiter,
@@ -951,6 +1967,38 @@ static struct PyMethodDef query_methods[] = {
     {NULL, NULL}
 };
 
+/* Get the wall time spent in libpq for this query. */
+static PyObject *
+query_elapsed(queryObject *self, void *closure)
+{
+    if (self->elapsed < 0) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return PyFloat_FromDouble(self->elapsed);
+}
+
+/* Get the number of rows reported in the command status tag. */
+static PyObject *
+query_rows_affected(queryObject *self, void *closure)
+{
+    if (self->rows_affected < 0) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return PyInt_FromLong(self->rows_affected);
+}
+
+/* Query object getters, filled when query capture mode is enabled
+   with capture_queries() on the connection. */
+static PyGetSetDef query_getsets[] = {
+    {"elapsed", (getter) query_elapsed, NULL,
+        "seconds spent waiting for the server, or None", NULL},
+    {"rows_affected", (getter) query_rows_affected, NULL,
+        "number of rows reported by the server, or None", NULL},
+    {NULL}
+};
+
 static char query__doc__[] = "PyGreSQL query object";
 
 /* Query type definition */
@@ -985,4 +2033,296 @@ static PyTypeObject queryType = {
     (getiterfunc) query_iter,    /* tp_iter */
     (iternextfunc) query_next,   /* tp_iternext */
     query_methods,               /* tp_methods */
+    0,                           /* tp_members */
+    query_getsets,               /* tp_getset */
 };
+
+#if IS_PY3
+
+/* The async query object is an awaitable returned by conn.query_async().
+   It drives the asynchronous query protocol off the readiness callbacks
+   of the running asyncio event loop, so that awaiting it never blocks
+   the loop thread, and finally resolves to the finished query object. */
+
+/* Remove the readiness watcher from the event loop, if one is set. */
+static int
+_async_query_unwatch(asyncQueryObject *self)
+{
+    PyObject *ret;
+
+    if (self->watching) {
+        ret = PyObject_CallMethod(
+            self->loop,
+            self->watching == 2 ? "remove_writer" : "remove_reader",
+            "i", self->fd);
+        self->watching = 0;
+        if (!ret) return 0;
+        Py_DECREF(ret);
+    }
+    return 1;
+}
+
+/* Restore the previous blocking mode of the connection when the
+   asynchronous round-trip is over. */
+static void
+_async_query_finish(asyncQueryObject *self)
+{
+    self->state = 2;
+    if (!self->nonblocking && self->pgcnx && self->pgcnx->cnx) {
+        PQsetnonblocking(self->pgcnx->cnx, 0);
+    }
+}
+
+/* Wake up a pending future when the socket becomes ready.
+   This is registered as reader/writer callback with the event loop. */
+static PyObject *
+_async_query_wake(PyObject *self, PyObject *future)
+{
+    PyObject *done, *ret;
+
+    if (!(done = PyObject_CallMethod(future, "done", NULL)))
+        return NULL;
+    if (PyObject_IsTrue(done)) {
+        Py_DECREF(done);
+        Py_RETURN_NONE;
+    }
+    Py_DECREF(done);
+    if (!(ret = PyObject_CallMethod(future, "set_result", "O", Py_None)))
+        return NULL;
+    Py_DECREF(ret);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef async_query_wake_method = {
+    "_wake", (PyCFunction) _async_query_wake, METH_O,
+    "internal callback waking up an awaited query"
+};
+
+/* Create a future for the next readiness event of the connection socket,
+   register it with the event loop and yield it to the awaiting task. */
+static PyObject *
+_async_query_wait(asyncQueryObject *self, int watch)
+{
+    PyObject *future, *ret;
+
+    if (!self->loop) {
+        PyObject *asyncio = PyImport_ImportModule("asyncio");
+
+        if (!asyncio) return NULL;
+        self->loop = PyObject_CallMethod(asyncio, "get_running_loop", NULL);
+        if (!self->loop && PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            /* Python < 3.7 does not have get_running_loop() yet */
+            PyErr_Clear();
+            self->loop = PyObject_CallMethod(asyncio, "get_event_loop", NULL);
+        }
+        Py_DECREF(asyncio);
+        if (!self->loop) return NULL;
+    }
+    if (!self->wake) {
+        self->wake = PyCFunction_NewEx(&async_query_wake_method, NULL, NULL);
+        if (!self->wake) return NULL;
+    }
+    if (!(future = PyObject_CallMethod(self->loop, "create_future", NULL)))
+        return NULL;
+    ret = PyObject_CallMethod(
+        self->loop, watch == 2 ? "add_writer" : "add_reader",
+        "iOO", self->fd, self->wake, future);
+    if (!ret) {
+        Py_DECREF(future); return NULL;
+    }
+    Py_DECREF(ret);
+    self->watching = watch;
+    /* mark the future so that the task machinery accepts it
+       as if it had been awaited directly */
+    if (PyObject_SetAttrString(
+        future, "_asyncio_future_blocking", Py_True))
+    {
+        _async_query_unwatch(self);
+        Py_DECREF(future); return NULL;
+    }
+    self->future = future;
+    Py_INCREF(future);
+    return future;
+}
+
+/* Advance the asynchronous query protocol by one step.  Yields a future
+   while the socket is not ready and finally raises StopIteration with
+   the finished query object as result of the await expression. */
+static PyObject *
+async_query_next(asyncQueryObject *self)
+{
+    PGconn *cnx;
+    int ok, busy;
+
+    if (self->state == 2) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Cannot reuse already awaited query");
+        return NULL;
+    }
+    if (!self->pgcnx || !(cnx = self->pgcnx->cnx)) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (self->future) {
+        /* woken up after a readiness event */
+        PyObject *ret;
+
+        if (!_async_query_unwatch(self)) {
+            Py_CLEAR(self->future);
+            _async_query_finish(self);
+            return NULL;
+        }
+        /* pass on a cancellation or failure of the future */
+        ret = PyObject_CallMethod(self->future, "result", NULL);
+        Py_CLEAR(self->future);
+        if (!ret) {
+            _async_query_finish(self);
+            return NULL;
+        }
+        Py_DECREF(ret);
+    }
+
+    if (self->state == 0) {
+        /* flush the outgoing query until the send buffer is empty */
+        int flushed;
+
+        Py_BEGIN_ALLOW_THREADS
+        flushed = PQflush(cnx);
+        Py_END_ALLOW_THREADS
+        if (flushed == -1) {
+            PyErr_SetString(OperationalError, PQerrorMessage(cnx));
+            _async_query_finish(self);
+            return NULL;
+        }
+        if (flushed == 1) {
+            /* send buffer is full, wait until the socket is writable */
+            return _async_query_wait(self, 2);
+        }
+        self->state = 1;
+    }
+
+    /* consume incoming data until the result is complete */
+    Py_BEGIN_ALLOW_THREADS
+    ok = PQconsumeInput(cnx);
+    busy = ok ? PQisBusy(cnx) : 0;
+    Py_END_ALLOW_THREADS
+    if (!ok) {
+        PyErr_SetString(OperationalError, PQerrorMessage(cnx));
+        _async_query_finish(self);
+        return NULL;
+    }
+    if (busy) {
+        /* result not complete yet, wait until the socket is readable */
+        return _async_query_wait(self, 1);
+    }
+
+    /* the result can now be fetched without blocking */
+    _async_query_finish(self);
+    PyErr_SetObject(PyExc_StopIteration, (PyObject *) self->query);
+    return NULL;
+}
+
+/* Return the iterator driving the await expression. */
+static PyObject *
+async_query_await(asyncQueryObject *self)
+{
+    Py_INCREF(self);
+    return (PyObject *) self;
+}
+
+/* Stop driving the query, e.g. when the awaiting task is cancelled. */
+static char async_query_close__doc__[] =
+"close() -- stop driving the query and unregister from the event loop";
+
+static PyObject *
+async_query_close(asyncQueryObject *self, PyObject *noargs)
+{
+    if (!_async_query_unwatch(self)) return NULL;
+    if (self->future) {
+        PyObject *ret = PyObject_CallMethod(self->future, "cancel", NULL);
+
+        Py_CLEAR(self->future);
+        if (!ret) return NULL;
+        Py_DECREF(ret);
+    }
+    if (self->state != 2) {
+        _async_query_finish(self);
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Deallocate the async query object. */
+static void
+async_query_dealloc(asyncQueryObject *self)
+{
+    if (self->watching || self->future || self->state != 2) {
+        PyObject *ret, *error_type, *error_value, *error_traceback;
+
+        PyErr_Fetch(&error_type, &error_value, &error_traceback);
+        ret = async_query_close(self, NULL);
+        if (ret)
+            Py_DECREF(ret);
+        else
+            PyErr_Clear();
+        PyErr_Restore(error_type, error_value, error_traceback);
+    }
+    Py_XDECREF(self->future);
+    Py_XDECREF(self->wake);
+    Py_XDECREF(self->loop);
+    Py_XDECREF(self->query);
+    Py_XDECREF(self->pgcnx);
+    PyObject_Del(self);
+}
+
+/* Async query methods */
+static struct PyMethodDef async_query_methods[] = {
+    {"close", (PyCFunction) async_query_close,
+        METH_NOARGS, async_query_close__doc__},
+    {NULL, NULL}
+};
+
+/* Async query await methods */
+static PyAsyncMethods async_query_as_async = {
+    (unaryfunc) async_query_await,   /* am_await */
+    0,                               /* am_aiter */
+    0,                               /* am_anext */
+};
+
+static char async_query__doc__[] = "PyGreSQL awaitable asynchronous query";
+
+/* Async query type definition */
+static PyTypeObject asyncQueryType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pg.AsyncQuery",                   /* tp_name */
+    sizeof(asyncQueryObject),          /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    /* methods */
+    (destructor) async_query_dealloc,  /* tp_dealloc */
+    0,                                 /* tp_print */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    &async_query_as_async,             /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    0,                                 /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    PyObject_GenericGetAttr,           /* tp_getattro */
+    0,                                 /* tp_setattro */
+    0,                                 /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    async_query__doc__,                /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    0,                                 /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    (getiterfunc) async_query_await,   /* tp_iter */
+    (iternextfunc) async_query_next,   /* tp_iternext */
+    async_query_methods,               /* tp_methods */
+};
+
+#endif /* IS_PY3 */
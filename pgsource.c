@@ -359,6 +359,177 @@ source_fetch(sourceObject *self, PyObject *args)
     return res_list;
 }
 
+/* Fetch rows and apply typecast functions in one go. */
+static char source_fetch_typed__doc__[] =
+"fetch_typed(casts, num) -- fetch rows with typecasts applied in C\n\n"
+"The casts must be a sequence with one entry per field: a callable,\n"
+"None for no cast, or True to cast the column natively in C based\n"
+"on its type OID.\n"
+"If the num parameter is omitted, the arraysize attribute is used.\n"
+"If num equals -1, all remaining rows are fetched.\n";
+
+static PyObject *
+source_fetch_typed(sourceObject *self, PyObject *args)
+{
+    PyObject *casts_obj, *casts, *res_list;
+    PyObject **cast_funcs;
+    int *col_types = NULL;
+    int i, k;
+    long size;
+#if IS_PY3
+    int encoding;
+#endif
+
+    /* checks validity */
+    if (!_check_source_obj(self, CHECK_RESULT | CHECK_DQL | CHECK_CNX)) {
+        return NULL;
+    }
+
+    /* checks args */
+    size = self->arraysize;
+    if (!PyArg_ParseTuple(args, "O|l", &casts_obj, &size)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "fetch_typed(casts, num), with casts (sequence)"
+                        " and num (integer, optional)");
+        return NULL;
+    }
+    if (!(casts = PySequence_Fast(casts_obj,
+        "Method fetch_typed() expects a sequence as first argument")))
+    {
+        return NULL;
+    }
+    if (PySequence_Fast_GET_SIZE(casts) != self->num_fields) {
+        Py_DECREF(casts);
+        PyErr_SetString(PyExc_ValueError,
+                        "Number of casts does not match number of fields");
+        return NULL;
+    }
+    /* resolve the cast table once for the whole block */
+    cast_funcs = PySequence_Fast_ITEMS(casts);
+    for (i = 0; i < self->num_fields; ++i) {
+        if (cast_funcs[i] == Py_True) {
+            if (!col_types) {
+                col_types = (int *) PyMem_Malloc(
+                    sizeof(int) * (size_t) self->num_fields);
+                if (!col_types) {
+                    Py_DECREF(casts); return PyErr_NoMemory();
+                }
+                memset(col_types, 0,
+                       sizeof(int) * (size_t) self->num_fields);
+            }
+            col_types[i] = get_dbapi_type(PQftype(self->result, i));
+        }
+        else if (cast_funcs[i] != Py_None
+                 && !PyCallable_Check(cast_funcs[i]))
+        {
+            PyMem_Free(col_types); Py_DECREF(casts);
+            PyErr_SetString(PyExc_TypeError,
+                            "The casts must be callables, None or True");
+            return NULL;
+        }
+    }
+
+    /* seeks last line */
+    /* limit size to be within the amount of data we actually have */
+    if (size < 0 || (self->max_row - self->current_row) < size) {
+        size = self->max_row - self->current_row;
+    }
+
+    /* allocate list for result */
+    if (!(res_list = PyList_New(size))) {
+        PyMem_Free(col_types); Py_DECREF(casts); return NULL;
+    }
+
+#if IS_PY3
+    encoding = self->encoding;
+#endif
+
+    /* builds result */
+    for (i = 0, k = self->current_row; i < size; ++i, ++k) {
+        PyObject *rowtuple;
+        int j;
+
+        if (!(rowtuple = PyTuple_New(self->num_fields))) {
+            Py_DECREF(res_list); PyMem_Free(col_types);
+            Py_DECREF(casts); return NULL;
+        }
+
+        for (j = 0; j < self->num_fields; ++j) {
+            PyObject *str;
+
+            if (PQgetisnull(self->result, k, j)) {
+                Py_INCREF(Py_None);
+                str = Py_None;
+            }
+            else {
+                char *s = PQgetvalue(self->result, k, j);
+                Py_ssize_t len = PQgetlength(self->result, k, j);
+
+                if (cast_funcs[j] == Py_True
+                    && PQfformat(self->result, j) == 0)
+                {
+                    /* cast natively based on the type OID of the column,
+                       without building an intermediate string object */
+                    switch (col_types[j]) {
+                        case PYGRES_INT:
+                        case PYGRES_LONG:
+                        case PYGRES_FLOAT:
+                            str = cast_sized_simple(s, len, col_types[j]);
+                            break;
+                        case PYGRES_BOOL:
+                            /* the DB-API 2 module always casts to bool,
+                               regardless of the bool_as_text setting */
+                            str = *s == 't' ? Py_True : Py_False;
+                            Py_INCREF(str);
+                            break;
+                        case PYGRES_BYTEA:
+                            str = cast_sized_text(s, len,
+                                self->encoding, PYGRES_BYTEA);
+                            break;
+                        default:  /* PYGRES_TEXT */
+                            str = cast_sized_text(s, len,
+                                self->encoding, PYGRES_TEXT);
+                    }
+                }
+                else {
+#if IS_PY3
+                    if (PQfformat(self->result, j) == 0) { /* textual */
+                        str = get_decoded_string(s, len, encoding);
+                        if (!str) /* cannot decode */
+                            str = PyBytes_FromStringAndSize(s, len);
+                    }
+                    else
+#endif
+                    str = PyBytes_FromStringAndSize(s, len);
+
+                    if (str && cast_funcs[j] != Py_None
+                        && cast_funcs[j] != Py_True)
+                    {
+                        PyObject *cast_value = PyObject_CallFunctionObjArgs(
+                            cast_funcs[j], str, NULL);
+
+                        Py_DECREF(str);
+                        str = cast_value;
+                    }
+                }
+                if (!str) {
+                    Py_DECREF(rowtuple); Py_DECREF(res_list);
+                    PyMem_Free(col_types); Py_DECREF(casts);
+                    return NULL;
+                }
+            }
+            PyTuple_SET_ITEM(rowtuple, j, str);
+        }
+
+        PyList_SET_ITEM(res_list, i, rowtuple);
+    }
+
+    self->current_row = k;
+    PyMem_Free(col_types);
+    Py_DECREF(casts);
+    return res_list;
+}
+
 /* Change current row (internal wrapper for all "move" methods). */
 static PyObject *
 _source_move(sourceObject *self, int move)
@@ -547,6 +718,157 @@ source_putdata(sourceObject *self, PyObject *buffer)
     return ret; /* None or number of rows */
 }
 
+/* Writing to file descriptors differs between Windows and Unix. */
+#ifdef MS_WINDOWS
+#define fd_write(fd, buf, size) _write(fd, buf, (unsigned int) (size))
+#else
+#define fd_write(fd, buf, size) write(fd, buf, (size_t) (size))
+#endif
+
+/* Get the final result after a COPY TO has been exhausted.
+   Returns the number of copied rows as a Python int, or NULL with an
+   exception set when the copy operation has failed. */
+static PyObject *
+_copy_out_done(PGconn *cnx)
+{
+    PGresult *result; /* final result of the operation */
+    PyObject *ret;
+
+    Py_BEGIN_ALLOW_THREADS;
+    result = PQgetResult(cnx);
+    Py_END_ALLOW_THREADS;
+
+    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+        char *tmp;
+        long num_rows;
+
+        tmp = PQcmdTuples(result);
+        num_rows = tmp[0] ? atol(tmp) : -1;
+        ret = PyInt_FromLong(num_rows);
+    }
+    else {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+        ret = NULL;
+    }
+    PQclear(result);
+
+    return ret;
+}
+
+/* Abort a COPY TO after an error while writing to the sink, draining
+   the remaining copy data so that the connection can be used again,
+   keeping the already set exception intact. */
+static void
+_copy_out_abort(PGconn *cnx)
+{
+    PyObject *err_type, *err_value, *err_tb;
+    PGresult *result;
+
+    PyErr_Fetch(&err_type, &err_value, &err_tb);
+    Py_BEGIN_ALLOW_THREADS;
+    for (;;) {
+        char *buffer;
+        int nbytes = PQgetCopyData(cnx, &buffer, 0);
+
+        if (nbytes <= 0) break; /* done, error or would block */
+        PQfreemem(buffer);
+    }
+    result = PQgetResult(cnx);
+    Py_END_ALLOW_THREADS;
+    if (result) PQclear(result);
+    PyErr_Restore(err_type, err_value, err_tb);
+}
+
+/* Write all pending copy data from the given connection to a sink,
+   which can be a file-like object with a write method or a plain file
+   descriptor.  Chunks are handed to a write method as zero-copy views
+   that free the libpq buffer when they are released; writes to a file
+   descriptor happen with the GIL released.  Returns 0 on success and
+   -1 with an exception set on error. */
+static int
+_copy_data_to_file(PGconn *cnx, PyObject *file_obj)
+{
+    PyObject *write_method = NULL;
+    char *buffer; /* the copied buffer allocated by libpq */
+    int fd = -1, nbytes;
+
+    if (PyInt_Check(file_obj)) {
+        fd = (int) PyInt_AsLong(file_obj);
+        if (fd < 0) {
+            PyErr_SetString(PyExc_ValueError, "Invalid file descriptor");
+            return -1;
+        }
+    }
+    else if (!(write_method = PyObject_GetAttrString(file_obj, "write"))) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError,
+                        "Expected a file-like object or a file descriptor");
+        return -1;
+    }
+
+    for (;;) {
+        int failed = 0;
+
+        Py_BEGIN_ALLOW_THREADS
+        nbytes = PQgetCopyData(cnx, &buffer, 0);
+        if (nbytes > 0 && fd >= 0) {
+            /* write to the descriptor without reacquiring the GIL */
+            char *p = buffer;
+            Py_ssize_t left = nbytes;
+
+            while (left > 0) {
+                Py_ssize_t written = (Py_ssize_t) fd_write(fd, p, left);
+
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    failed = 1; break;
+                }
+                p += written; left -= written;
+            }
+        }
+        Py_END_ALLOW_THREADS
+
+        if (!nbytes || nbytes < -1) { /* an error occurred */
+            Py_XDECREF(write_method);
+            PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+            return -1;
+        }
+        if (nbytes == -1) break; /* copy is done */
+        if (fd >= 0) {
+            int saved_errno = errno;
+
+            PQfreemem(buffer);
+            if (failed) {
+                errno = saved_errno;
+                Py_XDECREF(write_method);
+                PyErr_SetFromErrno(PyExc_IOError);
+                return -1;
+            }
+        }
+        else {
+            /* hand the chunk to the sink as a zero-copy view
+               that frees the libpq buffer when it is released */
+            PyObject *view, *ret;
+
+            view = _view_from_buffer(
+                NULL, buffer, buffer, (Py_ssize_t) nbytes);
+            if (!view) {
+                Py_DECREF(write_method);
+                return -1;
+            }
+            ret = PyObject_CallFunctionObjArgs(write_method, view, NULL);
+            Py_DECREF(view);
+            if (!ret) {
+                Py_DECREF(write_method);
+                return -1;
+            }
+            Py_DECREF(ret);
+        }
+    }
+    Py_XDECREF(write_method);
+    return 0;
+}
+
 /* Get copy data. */
 static char source_getdata__doc__[] =
 "getdata(decode) -- receive data to server during copy to stdout";
@@ -590,24 +912,7 @@ source_getdata(sourceObject *self, PyObject *args)
     }
 
     if (nbytes == -1) { /* copy is done */
-        PGresult *result; /* final result of the operation */
-
-        Py_BEGIN_ALLOW_THREADS;
-        result = PQgetResult(self->pgcnx->cnx);
-        Py_END_ALLOW_THREADS;
-
-        if (PQresultStatus(result) == PGRES_COMMAND_OK) {
-            char *tmp;
-            long num_rows;
-
-            tmp = PQcmdTuples(result);
-            num_rows = tmp[0] ? atol(tmp) : -1;
-            ret = PyInt_FromLong(num_rows);
-        }
-        else {
-            PyErr_SetString(PyExc_IOError, PQerrorMessage(self->pgcnx->cnx));
-            ret = NULL;
-        }
+        ret = _copy_out_done(self->pgcnx->cnx);
 
         PQclear(self->result);
         self->result = NULL;
@@ -623,6 +928,480 @@ source_getdata(sourceObject *self, PyObject *args)
     return ret; /* buffer or number of rows */
 }
 
+/* Get copy data as a zero-copy view. */
+static char source_getdata_view__doc__[] =
+"getdata_view() -- receive copy data as a zero-copy view";
+
+static PyObject *
+source_getdata_view(sourceObject *self, PyObject *noargs)
+{
+    char *buffer;       /* the copied buffer allocated by libpq */
+    int nbytes;         /* length of the buffer */
+    PyObject *ret;      /* return value */
+
+    /* checks validity */
+    if (!_check_source_obj(self, CHECK_CNX | CHECK_RESULT) ||
+        PQresultStatus(self->result) != PGRES_COPY_OUT)
+    {
+        PyErr_SetString(PyExc_IOError,
+                        "Connection is invalid or not in copy_out state");
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    nbytes = PQgetCopyData(self->pgcnx->cnx, &buffer, 0);
+    Py_END_ALLOW_THREADS
+
+    if (!nbytes || nbytes < -1) { /* an error occurred */
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(self->pgcnx->cnx));
+        return NULL;
+    }
+
+    if (nbytes == -1) { /* copy is done */
+        ret = _copy_out_done(self->pgcnx->cnx);
+
+        PQclear(self->result);
+        self->result = NULL;
+        self->result_type = RESULT_EMPTY;
+
+        return ret; /* number of rows */
+    }
+
+    /* wrap the chunk in a view that frees the buffer when released */
+    return _view_from_buffer(NULL, buffer, buffer, (Py_ssize_t) nbytes);
+}
+
+/* Write all copy data to a file. */
+static char source_copyto__doc__[] =
+"copyto(file) -- write all copy data to the given file or descriptor";
+
+static PyObject *
+source_copyto(sourceObject *self, PyObject *args)
+{
+    PyObject *file_obj; /* the file-like object or file descriptor */
+    PyObject *ret;      /* return value */
+
+    if (!PyArg_ParseTuple(args, "O", &file_obj)) {
+        return NULL;
+    }
+
+    /* checks validity */
+    if (!_check_source_obj(self, CHECK_CNX | CHECK_RESULT) ||
+        PQresultStatus(self->result) != PGRES_COPY_OUT)
+    {
+        PyErr_SetString(PyExc_IOError,
+                        "Connection is invalid or not in copy_out state");
+        return NULL;
+    }
+
+    if (_copy_data_to_file(self->pgcnx->cnx, file_obj)) {
+        /* drain the stream so the connection can be used again */
+        _copy_out_abort(self->pgcnx->cnx);
+
+        PQclear(self->result);
+        self->result = NULL;
+        self->result_type = RESULT_EMPTY;
+
+        return NULL;
+    }
+
+    ret = _copy_out_done(self->pgcnx->cnx);
+
+    PQclear(self->result);
+    self->result = NULL;
+    self->result_type = RESULT_EMPTY;
+
+    return ret; /* number of rows */
+}
+
+/* Run a COPY TO command and write all data to a file (connection
+   method declared in pgconn.c, defined here to share the helpers). */
+static PyObject *
+conn_copyto(connObject *self, PyObject *args)
+{
+    char *command;      /* the COPY TO STDOUT command */
+    PyObject *file_obj; /* the file-like object or file descriptor */
+    PGresult *result;   /* result of the COPY command */
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "sO", &command, &file_obj)) {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    result = PQexec(self->cnx, command);
+    Py_END_ALLOW_THREADS
+
+    if (!result || PQresultStatus(result) != PGRES_COPY_OUT) {
+        const char *err = PQerrorMessage(self->cnx);
+
+        if (result) PQclear(result);
+        PyErr_SetString(PyExc_IOError,
+                        *err ? err : "Command is not a copy to stdout");
+        return NULL;
+    }
+    PQclear(result);
+
+    if (_copy_data_to_file(self->cnx, file_obj)) {
+        /* drain the stream so the connection can be used again */
+        _copy_out_abort(self->cnx);
+        return NULL;
+    }
+
+    return _copy_out_done(self->cnx); /* number of rows */
+}
+
+/* Send one chunk of copy data to the server with the GIL released.
+   Returns 0 on success and -1 with an exception set on error. */
+static int
+_copy_send_data(PGconn *cnx, const char *buf, Py_ssize_t nbytes)
+{
+    while (nbytes > 0) {
+        int part = nbytes > INT_MAX ? INT_MAX : (int) nbytes;
+        int res;
+
+        Py_BEGIN_ALLOW_THREADS
+        res = PQputCopyData(cnx, buf, part);
+        Py_END_ALLOW_THREADS
+
+        if (res != 1) {
+            PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+            return -1;
+        }
+        buf += part; nbytes -= part;
+    }
+    return 0;
+}
+
+/* Get the final result after a COPY FROM has been terminated with
+   PQputCopyEnd().  Returns the number of copied rows as a Python int,
+   or NULL with an exception set when the copy operation has failed. */
+static PyObject *
+_copy_in_done(PGconn *cnx)
+{
+    PGresult *result; /* final result of the operation */
+    PyObject *ret;
+
+    if (PQputCopyEnd(cnx, NULL) != 1) {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS;
+    result = PQgetResult(cnx);
+    Py_END_ALLOW_THREADS;
+
+    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+        char *tmp;
+        long num_rows;
+
+        tmp = PQcmdTuples(result);
+        num_rows = tmp[0] ? atol(tmp) : -1;
+        ret = PyInt_FromLong(num_rows);
+    }
+    else {
+        PyErr_SetString(PyExc_IOError, PQerrorMessage(cnx));
+        ret = NULL;
+    }
+    PQclear(result);
+
+    return ret;
+}
+
+/* Abort a COPY FROM after an error while draining the data source,
+   keeping the already set exception intact. */
+static void
+_copy_in_abort(PGconn *cnx)
+{
+    PyObject *err_type, *err_value, *err_tb;
+    PGresult *result;
+
+    PyErr_Fetch(&err_type, &err_value, &err_tb);
+    if (PQputCopyEnd(cnx, "copy aborted") == 1) {
+        Py_BEGIN_ALLOW_THREADS;
+        result = PQgetResult(cnx);
+        Py_END_ALLOW_THREADS;
+        if (result) PQclear(result);
+    }
+    PyErr_Restore(err_type, err_value, err_tb);
+}
+
+/* Drain a data source into a COPY FROM operation on the given
+   connection.  The source can be a byte or unicode string holding the
+   complete data, a file-like object that is read in chunks of the
+   given buffer size -- through its readinto method when possible, so
+   that no intermediate Python bytes objects are created -- or any
+   other iterable yielding byte or unicode strings, whose chunks are
+   coalesced into writes of roughly the given buffer size.  The data
+   is flushed to the socket with the GIL released.  Returns 0 on
+   success and -1 with an exception set on error. */
+static int
+_copy_data_from_source(PGconn *cnx, PyObject *source_obj, int bufsize)
+{
+    PyObject *method, *iter, *item;
+    char *buffer, *buf;
+    Py_ssize_t nbytes, fill = 0;
+    int encoding = PQclientEncoding(cnx);
+
+    /* a string passed directly holds the complete data */
+    if (PyBytes_Check(source_obj)) {
+        PyBytes_AsStringAndSize(source_obj, &buf, &nbytes);
+        return _copy_send_data(cnx, buf, nbytes);
+    }
+    if (PyUnicode_Check(source_obj)) {
+        PyObject *tmp_obj = get_encoded_string(source_obj, encoding);
+        int res;
+
+        if (!tmp_obj) return -1; /* pass the UnicodeEncodeError */
+        PyBytes_AsStringAndSize(tmp_obj, &buf, &nbytes);
+        res = _copy_send_data(cnx, buf, nbytes);
+        Py_DECREF(tmp_obj);
+        return res;
+    }
+
+#if IS_PY3
+    if ((method = PyObject_GetAttrString(source_obj, "readinto"))) {
+        /* a file-like object is read straight into the send buffer */
+        PyObject *view;
+
+        if (!(buffer = (char *) PyMem_Malloc((size_t) bufsize))) {
+            Py_DECREF(method);
+            PyErr_NoMemory(); return -1;
+        }
+        view = PyMemoryView_FromMemory(buffer, bufsize, PyBUF_WRITE);
+        if (!view) {
+            PyMem_Free(buffer); Py_DECREF(method);
+            return -1;
+        }
+        for (;;) {
+            PyObject *num_obj = PyObject_CallFunctionObjArgs(
+                method, view, NULL);
+            Py_ssize_t num;
+
+            if (!num_obj) break;
+            num = PyNumber_AsSsize_t(num_obj, PyExc_OverflowError);
+            Py_DECREF(num_obj);
+            if (num < 0) {
+                if (!PyErr_Occurred())
+                    PyErr_SetString(PyExc_IOError,
+                                    "Error reading from the data source");
+                break;
+            }
+            if (!num) { /* end of the data source */
+                Py_DECREF(view); PyMem_Free(buffer); Py_DECREF(method);
+                return 0;
+            }
+            if (_copy_send_data(cnx, buffer, num)) break;
+        }
+        Py_DECREF(view); PyMem_Free(buffer); Py_DECREF(method);
+        return -1;
+    }
+    PyErr_Clear();
+#endif /* IS_PY3 */
+
+    if ((method = PyObject_GetAttrString(source_obj, "read"))) {
+        /* a file-like object without readinto is read chunk by chunk */
+        for (;;) {
+            PyObject *data = PyObject_CallFunction(method, "i", bufsize);
+            PyObject *tmp_obj = NULL;
+
+            if (!data) break;
+            if (PyBytes_Check(data)) {
+                PyBytes_AsStringAndSize(data, &buf, &nbytes);
+            }
+            else if (PyUnicode_Check(data)) {
+                tmp_obj = get_encoded_string(data, encoding);
+                if (!tmp_obj) {
+                    Py_DECREF(data);
+                    break; /* pass the UnicodeEncodeError */
+                }
+                PyBytes_AsStringAndSize(tmp_obj, &buf, &nbytes);
+            }
+            else {
+                Py_DECREF(data);
+                PyErr_SetString(PyExc_TypeError,
+                                "The read method of the data source must"
+                                " return byte or unicode strings");
+                break;
+            }
+            if (!nbytes) { /* end of the data source */
+                Py_XDECREF(tmp_obj); Py_DECREF(data); Py_DECREF(method);
+                return 0;
+            }
+            if (_copy_send_data(cnx, buf, nbytes)) {
+                Py_XDECREF(tmp_obj); Py_DECREF(data);
+                break;
+            }
+            Py_XDECREF(tmp_obj); Py_DECREF(data);
+        }
+        Py_DECREF(method);
+        return -1;
+    }
+    PyErr_Clear();
+
+    /* any other iterable yields the data chunk by chunk */
+    if (!(iter = PyObject_GetIter(source_obj))) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Expected a string, a file-like object"
+                        " or an iterable of strings");
+        return -1;
+    }
+    if (!(buffer = (char *) PyMem_Malloc((size_t) bufsize))) {
+        Py_DECREF(iter);
+        PyErr_NoMemory(); return -1;
+    }
+    while ((item = PyIter_Next(iter))) {
+        PyObject *tmp_obj = NULL;
+
+        if (PyBytes_Check(item)) {
+            PyBytes_AsStringAndSize(item, &buf, &nbytes);
+        }
+        else if (PyUnicode_Check(item)) {
+            tmp_obj = get_encoded_string(item, encoding);
+            if (!tmp_obj) {
+                Py_DECREF(item);
+                goto iter_error; /* pass the UnicodeEncodeError */
+            }
+            PyBytes_AsStringAndSize(tmp_obj, &buf, &nbytes);
+        }
+        else {
+            Py_DECREF(item);
+            PyErr_SetString(PyExc_TypeError,
+                            "The data source must yield"
+                            " byte or unicode strings");
+            goto iter_error;
+        }
+
+        /* coalesce small chunks into writes of the full buffer size */
+        if (fill && fill + nbytes > bufsize) {
+            if (_copy_send_data(cnx, buffer, fill)) {
+                Py_XDECREF(tmp_obj); Py_DECREF(item);
+                goto iter_error;
+            }
+            fill = 0;
+        }
+        if (nbytes >= bufsize) { /* large chunks are sent directly */
+            if (_copy_send_data(cnx, buf, nbytes)) {
+                Py_XDECREF(tmp_obj); Py_DECREF(item);
+                goto iter_error;
+            }
+        }
+        else {
+            memcpy(buffer + fill, buf, (size_t) nbytes);
+            fill += nbytes;
+        }
+        Py_XDECREF(tmp_obj); Py_DECREF(item);
+    }
+    if (PyErr_Occurred()) goto iter_error;
+    if (fill && _copy_send_data(cnx, buffer, fill)) goto iter_error;
+
+    PyMem_Free(buffer); Py_DECREF(iter);
+    return 0;
+
+iter_error:
+    PyMem_Free(buffer); Py_DECREF(iter);
+    return -1;
+}
+
+/* Send all copy data from a data source. */
+static char source_copyfrom__doc__[] =
+"copyfrom(data, [buffer_size]) -- send all copy data from a data source\n\n"
+"The data can be a string with the complete data, a file-like object\n"
+"that is read in chunks of the given buffer size, or any iterable\n"
+"yielding strings, whose chunks are coalesced into large writes.\n"
+"The number of copied rows is returned.\n";
+
+static PyObject *
+source_copyfrom(sourceObject *self, PyObject *args)
+{
+    PyObject *source_obj; /* the data source */
+    PyObject *ret;        /* return value */
+    int bufsize = COPY_BUFFER_SIZE;
+
+    if (!PyArg_ParseTuple(args, "O|i", &source_obj, &bufsize)) {
+        return NULL;
+    }
+    if (bufsize <= 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Method copyfrom() expects a positive buffer size");
+        return NULL;
+    }
+
+    /* checks validity */
+    if (!_check_source_obj(self, CHECK_CNX | CHECK_RESULT) ||
+        PQresultStatus(self->result) != PGRES_COPY_IN)
+    {
+        PyErr_SetString(PyExc_IOError,
+                        "Connection is invalid or not in copy_in state");
+        return NULL;
+    }
+
+    if (_copy_data_from_source(self->pgcnx->cnx, source_obj, bufsize)) {
+        _copy_in_abort(self->pgcnx->cnx);
+        ret = NULL;
+    }
+    else {
+        ret = _copy_in_done(self->pgcnx->cnx);
+    }
+
+    PQclear(self->result);
+    self->result = NULL;
+    self->result_type = RESULT_EMPTY;
+
+    return ret; /* number of rows */
+}
+
+/* Run a COPY FROM command and send all data from a data source
+   (connection method declared in pgconn.c, defined here to share
+   the copy helpers of the source object). */
+static PyObject *
+conn_copyfrom(connObject *self, PyObject *args)
+{
+    char *command;        /* the COPY FROM STDIN command */
+    PyObject *source_obj; /* the data source */
+    PGresult *result;     /* result of the COPY command */
+    int bufsize = COPY_BUFFER_SIZE;
+
+    if (!self->cnx) {
+        PyErr_SetString(PyExc_TypeError, "Connection is not valid");
+        return NULL;
+    }
+
+    if (!PyArg_ParseTuple(args, "sO|i", &command, &source_obj, &bufsize)) {
+        return NULL;
+    }
+    if (bufsize <= 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "Method copyfrom() expects a positive buffer size");
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    result = PQexec(self->cnx, command);
+    Py_END_ALLOW_THREADS
+
+    if (!result || PQresultStatus(result) != PGRES_COPY_IN) {
+        const char *err = PQerrorMessage(self->cnx);
+
+        if (result) PQclear(result);
+        PyErr_SetString(PyExc_IOError,
+                        *err ? err : "Command is not a copy from stdin");
+        return NULL;
+    }
+    PQclear(result);
+
+    if (_copy_data_from_source(self->cnx, source_obj, bufsize)) {
+        _copy_in_abort(self->cnx);
+        return NULL;
+    }
+
+    return _copy_in_done(self->cnx); /* number of rows */
+}
+
 /* Find field number from string/integer (internal use only). */
 static int
 _source_fieldindex(sourceObject *self, PyObject *param, const char *usage)
@@ -781,6 +1560,8 @@ static PyMethodDef source_methods[] = {
         METH_NOARGS, source_oidstatus__doc__},
     {"fetch", (PyCFunction) source_fetch,
         METH_VARARGS, source_fetch__doc__},
+    {"fetch_typed", (PyCFunction) source_fetch_typed,
+        METH_VARARGS, source_fetch_typed__doc__},
     {"movefirst", (PyCFunction) source_movefirst,
         METH_NOARGS, source_movefirst__doc__},
     {"movelast", (PyCFunction) source_movelast,
@@ -793,6 +1574,12 @@ static PyMethodDef source_methods[] = {
         METH_O, source_putdata__doc__},
     {"getdata", (PyCFunction) source_getdata,
         METH_VARARGS, source_getdata__doc__},
+    {"getdata_view", (PyCFunction) source_getdata_view,
+        METH_NOARGS, source_getdata_view__doc__},
+    {"copyto", (PyCFunction) source_copyto,
+        METH_VARARGS, source_copyto__doc__},
+    {"copyfrom", (PyCFunction) source_copyfrom,
+        METH_VARARGS, source_copyfrom__doc__},
     {"field", (PyCFunction) source_field,
         METH_O, source_field__doc__},
     {"fieldinfo", (PyCFunction) source_fieldinfo,
@@ -47,6 +47,7 @@ try:
     from setuptools import setup
 except ImportError:
     from distutils.core import setup
+from distutils.core import Command
 from distutils.extension import Extension
 from distutils.command.build_ext import build_ext
 from distutils.ccompiler import get_default_compiler
@@ -118,11 +119,13 @@ class build_pg_ext(build_ext):
         ('ssl-info', None, "use new ssl info functions"),
         ('no-ssl-info', None, "do not use new ssl info functions"),
         ('memory-size', None, "enable new memory size function"),
-        ('no-memory-size', None, "disable new memory size function")]
+        ('no-memory-size', None, "disable new memory size function"),
+        ('pipeline-mode', None, "enable pipeline mode support"),
+        ('no-pipeline-mode', None, "disable pipeline mode support")]
 
     boolean_options = build_ext.boolean_options + [
         'strict', 'direct-access', 'large-objects', 'default-vars',
-        'escaping-funcs', 'ssl-info', 'memory-size']
+        'escaping-funcs', 'ssl-info', 'memory-size', 'pipeline-mode']
 
     negative_opt = {
         'no-direct-access': 'direct-access',
@@ -130,7 +133,8 @@ class build_pg_ext(build_ext):
         'no-default-vars': 'default-vars',
         'no-escaping-funcs': 'escaping-funcs',
         'no-ssl-info': 'ssl-info',
-        'no-memory-size': 'memory-size'}
+        'no-memory-size': 'memory-size',
+        'no-pipeline-mode': 'pipeline-mode'}
 
     def get_compiler(self):
         """Return the C compiler used for building the extension."""
@@ -146,6 +150,7 @@ class build_pg_ext(build_ext):
         self.pqlib_info = None
         self.ssl_info = None
         self.memory_size = None
+        self.pipeline_mode = None
         supported = pg_version >= (9, 0)
         if not supported:
             warnings.warn(
@@ -194,6 +199,14 @@ class build_pg_ext(build_ext):
                 warnings.warn(
                     "The installed PostgreSQL version"
                     " does not support the memory size function.")
+        wanted = self.pipeline_mode
+        supported = pg_version >= (14, 0)
+        if wanted or (wanted is None and supported):
+            define_macros.append(('PIPELINE_MODE', None))
+            if not supported:
+                warnings.warn(
+                    "The installed PostgreSQL version"
+                    " does not support pipeline mode.")
         if sys.platform == 'win32':
             libraries[0] = 'lib' + libraries[0]
             if os.path.exists(os.path.join(
@@ -209,6 +222,33 @@ class build_pg_ext(build_ext):
                     '-Dinline=__inline']  # needed for MSVC 9
 
 
+class bench_pg(Command):
+    """Custom command running the PyGreSQL micro-benchmark suite."""
+
+    description = "run the PyGreSQL micro-benchmark suite"
+
+    user_options = [
+        ('output=', 'o', "file name for the benchmark results (JSON)"),
+        ('fast', 'f', "get rough results more quickly")]
+
+    boolean_options = ['fast']
+
+    def initialize_options(self):
+        self.output = None
+        self.fast = False
+
+    def finalize_options(self):
+        pass
+
+    def run(self):
+        args = [sys.executable, os.path.join('bench', 'benchmarks.py')]
+        if self.output:
+            args.extend(['--output', self.output])
+        if self.fast:
+            args.append('--fast')
+        self.spawn(args)
+
+
 setup(
     name="PyGreSQL",
     version=version,
@@ -234,7 +274,7 @@ setup(
         define_macros=define_macros, undef_macros=undef_macros,
         libraries=libraries, extra_compile_args=extra_compile_args)],
     zip_safe=False,
-    cmdclass=dict(build_ext=build_pg_ext),
+    cmdclass=dict(build_ext=build_pg_ext, bench=bench_pg),
     test_suite='tests.discover',
     classifiers=[
         "Development Status :: 6 - Mature",
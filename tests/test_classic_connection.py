@@ -14,6 +14,7 @@ import unittest
 import threading
 import time
 import os
+import struct
 
 from collections import namedtuple
 
@@ -162,14 +163,23 @@ class TestConnectObject(unittest.TestCase):
 
     def testAllConnectMethods(self):
         methods = '''
-            cancel close date_format describe_prepared endcopy
-            escape_bytea escape_identifier escape_literal escape_string
-            fileno get_cast_hook get_notice_receiver getline getlo getnotify
-            inserttable is_non_blocking locreate loimport parameter poll
-            prepare putline query query_prepared reset send_query
+            cancel capture_queries close collect_notices copyfrom copyto
+            date_format describe_prepared
+            endcopy
+            enter_pipeline_mode escape_bytea escape_identifier
+            escape_literal escape_string executemany exit_pipeline_mode
+            fileno get_cast_hook get_notice_receiver
+            get_statement_cache_size getline getlo getnotify
+            inserttable inserttable_binary is_non_blocking
+            locreate loimport notices parameter
+            pipeline_status pipeline_sync poll
+            prepare putline query query_async query_binary query_prepared
+            query_streaming reset send_query
             set_cast_hook set_non_blocking set_notice_receiver
-            source transaction
+            set_statement_cache_size source stats transaction wait_notify
             '''.split()
+        if str is bytes:  # Python 2 has no awaitable queries
+            methods.remove('query_async')
         connection_methods = [
             a for a in dir(self.connection)
             if not a.startswith('__') and self.is_method(a)]
@@ -509,6 +519,177 @@ class TestSimpleQueries(unittest.TestCase):
         self.assertEqual(r, result)
         self.assertIsNone(query.getresult())
 
+    def testGetresultBinary(self):
+        q = ("select 1::int2, 2::int4, 9876543210::int8, 3.5::float4,"
+             " 4.75::float8, true, 'hello'::text, 12345.6789::numeric")
+        v = self.c.query_binary(q).getresult()[0]
+        self.assertEqual(v, (1, 2, 9876543210, 3.5, 4.75, True,
+                             'hello', Decimal('12345.6789')))
+        self.assertIsInstance(v[2], long)
+        self.assertIsInstance(v[4], float)
+        self.assertIsInstance(v[7], Decimal)
+
+    def testGetresultBinaryArray(self):
+        q = "select array[[1,2],[3,4]]::int4[], array[2.5,null]::float8[]"
+        v = self.c.query_binary(q).getresult()[0]
+        self.assertEqual(v, ([[1, 2], [3, 4]], [2.5, None]))
+
+    def testGetresultBinaryBytea(self):
+        q = "select 'plain'::bytea"
+        v = self.c.query_binary(q).getresult()[0][0]
+        self.assertIsInstance(v, bytes)
+        self.assertEqual(v, b'plain')
+
+    def testGetresultBinaryDatetime(self):
+        from datetime import date, datetime
+        q = ("select '2020-12-09'::date,"
+             " '2020-12-09 12:34:56.789012'::timestamp")
+        v = self.c.query_binary(q).getresult()[0]
+        self.assertEqual(v, (date(2020, 12, 9),
+                             datetime(2020, 12, 9, 12, 34, 56, 789012)))
+
+    @unittest.skipIf(pg.get_pqlib_version() < 140000,
+                     "pipeline mode needs libpq 14 or newer")
+    def testPipelineMode(self):
+        self.assertEqual(self.c.pipeline_status(), pg.PIPELINE_OFF)
+        self.c.enter_pipeline_mode()
+        try:
+            self.assertEqual(self.c.pipeline_status(), pg.PIPELINE_ON)
+            queries = [self.c.send_query("select %d" % (n,))
+                       for n in range(3)]
+            self.c.pipeline_sync()
+            for n, query in enumerate(queries):
+                self.assertEqual(query.getresult(), [(n,)])
+                self.assertIsNone(query.getresult())
+        finally:
+            self.c.exit_pipeline_mode()
+        self.assertEqual(self.c.pipeline_status(), pg.PIPELINE_OFF)
+
+    def testQueryStreaming(self):
+        q = self.c.query_streaming("select generate_series(1,100)")
+        r = list(q)
+        self.assertEqual(r, [(n,) for n in range(1, 101)])
+        self.assertIsNone(q.getresult())
+        # the connection must have left the busy state after the last
+        # row, so new queries can be sent without an intervening query()
+        q = self.c.send_query("select 2")
+        self.assertEqual(q.getresult(), [(2,)])
+        self.assertIsNone(q.getresult())
+
+    def testQueryStreamingAbandoned(self):
+        q = self.c.query_streaming("select generate_series(1,1000000)")
+        for n, row in enumerate(q):
+            self.assertEqual(row, (n + 1,))
+            if n >= 2:
+                break
+        del q
+        # the connection must be usable again after abandoning the query
+        self.assertEqual(self.c.query("select 1").getresult(), [(1,)])
+
+    def testQueryAsync(self):
+        if not hasattr(self.c, 'query_async'):
+            self.skipTest('Python 2 has no asyncio support')
+        import asyncio
+        # use exec() so that this file stays parseable with Python 2
+        code = (
+            'async def run(c):\n'
+            '    q = await c.query_async("select generate_series(1,3)")\n'
+            '    return q.getresult()\n')
+        scope = {}
+        exec(code, scope)
+        loop = asyncio.new_event_loop()
+        try:
+            r = loop.run_until_complete(scope['run'](self.c))
+        finally:
+            loop.close()
+        self.assertEqual(r, [(1,), (2,), (3,)])
+        # the connection must be usable for blocking queries again
+        self.assertEqual(self.c.query("select 1").getresult(), [(1,)])
+
+    def testQueryAsyncWithParams(self):
+        if not hasattr(self.c, 'query_async'):
+            self.skipTest('Python 2 has no asyncio support')
+        import asyncio
+        code = (
+            'async def run(c):\n'
+            '    results = []\n'
+            '    for i in range(3):\n'
+            '        q = await c.query_async(\n'
+            '            "select $1::int + $2::int", (i, 1))\n'
+            '        results.append(q.getresult()[0][0])\n'
+            '    return results\n')
+        scope = {}
+        exec(code, scope)
+        loop = asyncio.new_event_loop()
+        try:
+            r = loop.run_until_complete(scope['run'](self.c))
+        finally:
+            loop.close()
+        self.assertEqual(r, [1, 2, 3])
+
+    def testGetcolumns(self):
+        q = ("select 1 as i, 2.5 as f, true as b, 'x' as t"
+             " union all select null, null, null, null"
+             " union all select 3, 0.5, false, 'y'")
+        r = self.c.query(q).getcolumns()
+        self.assertIsInstance(r, dict)
+        self.assertEqual(sorted(r), ['b', 'f', 'i', 't'])
+        typecode, values, nulls = r['i']
+        self.assertEqual(typecode, 'q')
+        self.assertIsInstance(values, bytearray)
+        self.assertEqual(len(values), 3 * 8)
+        self.assertEqual(list(struct.unpack('=3q', values)), [1, 0, 3])
+        self.assertEqual(list(nulls), [0, 1, 0])
+        typecode, values, nulls = r['f']
+        self.assertEqual(typecode, 'd')
+        self.assertEqual(list(struct.unpack('=3d', values)), [2.5, 0.0, 0.5])
+        self.assertEqual(list(nulls), [0, 1, 0])
+        typecode, values, nulls = r['b']
+        self.assertEqual(typecode, 'B')
+        self.assertEqual(list(values), [1, 0, 0])
+        self.assertEqual(list(nulls), [0, 1, 0])
+        typecode, values, nulls = r['t']
+        self.assertIsNone(typecode)
+        self.assertEqual(values, ['x', None, 'y'])
+        self.assertEqual(list(nulls), [0, 1, 0])
+
+    def testGetcolumnsBinary(self):
+        q = "select generate_series(1,5) as n"
+        typecode, values, nulls = self.c.query_binary(q).getcolumns()['n']
+        self.assertEqual(typecode, 'q')
+        self.assertEqual(list(struct.unpack('=5q', values)), [1, 2, 3, 4, 5])
+        self.assertEqual(list(nulls), [0] * 5)
+
+    def testLazyresult(self):
+        q = "select 1 as one, 'two' as two, null as three"
+        r = self.c.query(q).lazyresult()
+        self.assertIsInstance(r, list)
+        self.assertEqual(len(r), 1)
+        row = r[0]
+        self.assertEqual(len(row), 3)
+        self.assertEqual(row[0], 1)
+        self.assertEqual(row[1], 'two')
+        self.assertIsNone(row[2])
+        self.assertEqual(row[-2], 'two')
+        self.assertEqual(row['one'], 1)
+        self.assertEqual(row['two'], 'two')
+        self.assertEqual(row.one, 1)
+        self.assertEqual(row.two, 'two')
+        self.assertRaises(IndexError, row.__getitem__, 3)
+        self.assertRaises(KeyError, row.__getitem__, 'four')
+        self.assertRaises(AttributeError, getattr, row, 'four')
+        self.assertRaises(TypeError, row.__getitem__, 1.5)
+        self.assertEqual(str(row), str((1, 'two', None)))
+
+    def testLazyresultIsLazy(self):
+        q = "select 1 as n, 'not a number' as garbage"
+        row = self.c.query_binary(q).lazyresult()[0]
+        # accessing one column does not cast the other ones
+        self.assertEqual(row.n, 1)
+        # memoized values are returned consistently
+        self.assertEqual(row.n, 1)
+        self.assertEqual(row['n'], 1)
+
     def testDictresult(self):
         q = "select 0 as alias0"
         result = [{'alias0': 0}]
@@ -1066,6 +1247,32 @@ class TestParamQueries(unittest.TestCase):
     def testQueryWithBoolParamsNotDefault(self):
         self.testQueryWithBoolParams(bool_enabled=not pg.get_bool())
 
+    def testExecutemany(self):
+        executemany = self.c.executemany
+        query = self.c.query
+        self.assertRaises(TypeError, executemany)
+        self.assertRaises(TypeError, executemany, "select $1")
+        self.assertRaises(TypeError, executemany, 42, [])
+        self.assertRaises(TypeError, executemany, "select $1", 42)
+        self.assertRaises(TypeError, executemany, "select $1", [42])
+        query("create temp table test_executemany (n int, t text)")
+        q = "insert into test_executemany values ($1, $2)"
+        r = executemany(q, [])
+        self.assertIsInstance(r, int)
+        self.assertEqual(r, 0)
+        r = executemany(q, [(1, 'one')])
+        self.assertEqual(r, 1)
+        r = executemany(q, [(2, 'two'), [3, None], (4, u'käse')])
+        self.assertEqual(r, 3)
+        r = query("select * from test_executemany order by n").getresult()
+        self.assertEqual(r, [(1, 'one'), (2, 'two'), (3, None), (4, u'käse')])
+        self.assertRaises(ValueError, executemany, q, [(5, 'x'), (6,)])
+        r = executemany("update test_executemany set t = $1", [('same',)])
+        self.assertEqual(r, 4)
+        self.assertRaises(
+            pg.ProgrammingError, executemany,
+            "insert into test_executemany values ($1)", [('bad',)])
+
     def testQueryWithIntParams(self):
         query = self.c.query
         self.assertEqual(query("select 1+1").getresult(), [(2,)])
@@ -1214,6 +1421,36 @@ class TestParamQueries(unittest.TestCase):
                          (garbage,)).dictresult(),
             [{'garbage': garbage}])
 
+    def testStatementCacheSize(self):
+        query = self.c.query
+        num_prepared = ("select count(*) from pg_prepared_statements"
+                        " where name like 'pygresql_%'")
+        self.assertEqual(self.c.get_statement_cache_size(), 64)
+        self.assertRaises(ValueError, self.c.set_statement_cache_size, -1)
+        self.c.set_statement_cache_size(2)
+        self.assertEqual(self.c.get_statement_cache_size(), 2)
+        for i in range(3):
+            for n in (1, 2, 3):
+                q = "select $1::int + %d" % n
+                self.assertEqual(query(q, (i,)).getresult(), [(i + n,)])
+        # the cache must evict statements down to the configured size
+        self.assertEqual(query(num_prepared).getresult(), [(2,)])
+        # changing the size must deallocate the cached statements
+        self.c.set_statement_cache_size(0)
+        self.assertEqual(query(num_prepared).getresult(), [(0,)])
+        # queries with parameters must still work with the cache disabled
+        self.assertEqual(query("select $1::int", (42,)).getresult(), [(42,)])
+
+    def testStatementCacheReprepares(self):
+        query = self.c.query
+        q = "select $1::int + 1"
+        query("begin")
+        self.assertEqual(query(q, (1,)).getresult(), [(2,)])
+        # roll back the transaction that prepared the statement
+        query("rollback")
+        # the statement must be transparently prepared again
+        self.assertEqual(query(q, (2,)).getresult(), [(3,)])
+
 
 class TestPreparedQueries(unittest.TestCase):
     """Test prepared queries via a basic pg connection."""
@@ -1764,6 +2001,96 @@ class TestQueryOneSingleScalar(unittest.TestCase):
         r = list(r)
         self.assertEqual(r, [1, 3])
 
+    def testCopyto(self):
+        from io import BytesIO
+        query = self.c.query
+        query("create temp table test_copyto (n int, t text)")
+        query("insert into test_copyto values (1, 'one'), (2, 'two')")
+        sink = BytesIO()
+        r = self.c.copyto("copy test_copyto to stdout", sink)
+        self.assertEqual(r, 2)
+        self.assertEqual(sink.getvalue(), b'1\tone\n2\ttwo\n')
+        # writing directly to a file descriptor also works
+        import tempfile
+        fd, fname = tempfile.mkstemp()
+        try:
+            r = self.c.copyto("copy test_copyto to stdout", fd)
+            os.close(fd)
+            self.assertEqual(r, 2)
+            with open(fname, 'rb') as f:
+                self.assertEqual(f.read(), b'1\tone\n2\ttwo\n')
+        finally:
+            os.unlink(fname)
+        # commands that do not copy to stdout are rejected
+        self.assertRaises(IOError, self.c.copyto, "select 1", sink)
+        # errors raised by the sink abort the copy operation
+        class BadSink:
+            def write(self, data):
+                raise RuntimeError('sink failed')
+        self.assertRaises(RuntimeError, self.c.copyto,
+                          "copy test_copyto to stdout", BadSink())
+        # the connection must be usable again after the error
+        r = query("select count(*) from test_copyto").getresult()[0][0]
+        self.assertEqual(r, 2)
+
+    def testCopytoSource(self):
+        query = self.c.query
+        query("create temp table test_copyto_src (n int)")
+        query("insert into test_copyto_src values (1), (2), (3)")
+        source = self.c.source()
+        source.execute("copy test_copyto_src to stdout")
+        # chunks are returned as zero-copy views over the libpq buffers
+        chunks = []
+        while True:
+            chunk = source.getdata_view()
+            if isinstance(chunk, int):
+                self.assertEqual(chunk, 3)
+                break
+            self.assertNotIsInstance(chunk, bytes)
+            chunks.append(chunk.tobytes())
+        self.assertEqual(b''.join(chunks), b'1\n2\n3\n')
+        source.close()
+
+    def testCopyfrom(self):
+        from io import BytesIO
+        query = self.c.query
+        query("create temp table test_copyfrom (n int, t text)")
+        r = self.c.copyfrom(
+            "copy test_copyfrom from stdin", BytesIO(b'1\tone\n2\ttwo\n'))
+        self.assertEqual(r, 2)
+        r = query("select * from test_copyfrom order by n").getresult()
+        self.assertEqual(r, [(1, 'one'), (2, 'two')])
+        # the data can also be passed as a string or an iterable
+        r = self.c.copyfrom("copy test_copyfrom from stdin", '3\tthree\n')
+        self.assertEqual(r, 1)
+        r = self.c.copyfrom(
+            "copy test_copyfrom from stdin",
+            (('%d\t#%d\n' % (n, n)).encode('ascii') for n in range(4, 7)), 8)
+        self.assertEqual(r, 3)
+        r = query("select count(*) from test_copyfrom").getresult()[0][0]
+        self.assertEqual(r, 6)
+        # commands that do not copy from stdin are rejected
+        self.assertRaises(IOError, self.c.copyfrom, "select 1", BytesIO())
+        # errors raised by the data source abort the copy operation
+        def bad_source():
+            yield b'7\tseven\n'
+            raise RuntimeError('data source failed')
+        self.assertRaises(RuntimeError, self.c.copyfrom,
+                          "copy test_copyfrom from stdin", bad_source())
+        r = query("select count(*) from test_copyfrom").getresult()[0][0]
+        self.assertEqual(r, 6)
+
+    def testCopyfromSource(self):
+        query = self.c.query
+        query("create temp table test_copyfrom_src (n int)")
+        source = self.c.source()
+        source.execute("copy test_copyfrom_src from stdin")
+        r = source.copyfrom([b'1\n', '2\n', b'3\n'])
+        self.assertEqual(r, 3)
+        r = query("select * from test_copyfrom_src order by n").getresult()
+        self.assertEqual(r, [(1,), (2,), (3,)])
+        source.close()
+
 
 class TestInserttable(unittest.TestCase):
     """Test inserttable method."""
@@ -2075,6 +2402,40 @@ class TestInserttable(unittest.TestCase):
         # cannot encode non-ascii unicode without a specific encoding
         self.assertRaises(UnicodeEncodeError, self.c.inserttable, 'test', data)
 
+    def testInserttableBinary(self):
+        from datetime import date, time
+        data = [
+            (n, n, long(n), bool(n % 2), date(2020, 12, n + 1), time(n, 30),
+             Decimal(n * 5) / 4, n + 0.25, n + 0.125, None,
+             'c', 'v%d' % n, 'c4', 'text %d' % n)
+            for n in range(4)]
+        self.c.inserttable_binary('test', data)
+        r = self.c.query("select * from test order by 1").getresult()
+        self.assertEqual(len(r), 4)
+        for n, row in enumerate(r):
+            self.assertEqual(row[:4], (n, n, n, bool(n % 2)))
+            self.assertEqual(row[4], '2020-12-0%d' % (n + 1))
+            self.assertEqual(row[5], '%02d:30:00' % n)
+            self.assertEqual(row[6], Decimal(n * 5) / 4)
+            self.assertEqual(row[7], n + 0.25)
+            self.assertEqual(row[8], n + 0.125)
+            self.assertIsNone(row[9])
+            self.assertEqual(row[10:], ('c', 'v%d' % n, 'c4  ', 'text %d' % n))
+
+    def testInserttableBinaryFromIterator(self):
+        data = ((n, 'row %d' % n) for n in range(100))
+        self.c.inserttable_binary('test', data, ['i4', 't'], 1024)
+        r = self.c.query("select count(*), sum(i4), min(t), max(t)"
+                         " from test").getresult()[0]
+        self.assertEqual(r, (100, sum(range(100)), 'row 0', 'row 99'))
+
+    def testInserttableBinaryWrongRowSize(self):
+        data = [(1, 2)]
+        self.assertRaises(
+            TypeError, self.c.inserttable_binary, 'test', data)
+        # the connection must still be usable after the error
+        self.assertEqual(self.c.query("select 1").getresult(), [(1,)])
+
 
 class TestDirectSocketAccess(unittest.TestCase):
     """Test copy command with direct socket access."""
@@ -2229,6 +2590,73 @@ class TestNotificatons(unittest.TestCase):
         finally:
             query('unlisten test_notify')
 
+    def testWaitNotify(self):
+        wait_notify = self.c.wait_notify
+        query = self.c.query
+        self.assertRaises(ValueError, wait_notify, -1)
+        self.assertRaises(TypeError, wait_notify, 'timeout')
+        # with a zero timeout, only buffered notifications are drained
+        self.assertEqual(wait_notify(0), [])
+        query('listen test_wait_notify')
+        try:
+            query("notify test_wait_notify")
+            query("notify test_wait_notify, 'test_payload'")
+            r = wait_notify(10)
+            self.assertIsInstance(r, list)
+            self.assertEqual(len(r), 2)
+            for t in r:
+                self.assertIsInstance(t, tuple)
+                self.assertEqual(len(t), 3)
+                self.assertEqual(t[0], 'test_wait_notify')
+                self.assertIsInstance(t[1], int)
+            self.assertEqual(r[0][2], '')
+            self.assertEqual(r[1][2], 'test_payload')
+            self.assertEqual(wait_notify(0), [])
+            # notifications from other connections wake up the wait
+            c2 = connect()
+            try:
+                c2.query("notify test_wait_notify, 'from_other'")
+            finally:
+                c2.close()
+            r = wait_notify(10)
+            self.assertEqual(len(r), 1)
+            self.assertEqual(r[0][2], 'from_other')
+            # an expired timeout yields an empty list
+            self.assertEqual(wait_notify(0.01), [])
+        finally:
+            query('unlisten test_wait_notify')
+
+    def testStats(self):
+        c = connect()
+        try:
+            stats = c.stats()
+            self.assertIsInstance(stats, dict)
+            self.assertEqual(sorted(stats), [
+                'bytes', 'cache_hits', 'cache_misses', 'cast_time',
+                'queries', 'rows', 'server_time'])
+            self.assertEqual(stats['queries'], 0)
+            self.assertEqual(stats['rows'], 0)
+            self.assertEqual(stats['bytes'], 0)
+            self.assertEqual(stats['server_time'], 0)
+            self.assertEqual(stats['cast_time'], 0)
+            r = c.query("select 'hello'").getresult()
+            self.assertEqual(r, [('hello',)])
+            stats = c.stats()
+            self.assertEqual(stats['queries'], 1)
+            self.assertEqual(stats['rows'], 1)
+            self.assertEqual(stats['bytes'], 5)
+            self.assertGreater(stats['server_time'], 0)
+            self.assertGreaterEqual(stats['cast_time'], 0)
+            # the same parameterized query hits the statement cache
+            c.query('select $1::int', (1,)).getresult()
+            c.query('select $1::int', (2,)).getresult()
+            stats = c.stats()
+            self.assertEqual(stats['queries'], 3)
+            self.assertEqual(stats['cache_misses'], 1)
+            self.assertEqual(stats['cache_hits'], 1)
+        finally:
+            c.close()
+
     def testGetNoticeReceiver(self):
         self.assertIsNone(self.c.get_notice_receiver())
 
@@ -2270,6 +2698,210 @@ class TestNotificatons(unittest.TestCase):
             severity='WARNING', primary='Bilbo was here!',
             detail=None, hint=None))
 
+    def testCollectNotices(self):
+        query = self.c.query
+        self.assertRaises(ValueError, self.c.collect_notices, -1)
+        self.assertRaises(ValueError, self.c.collect_notices, 10, 'BAD')
+        self.assertEqual(self.c.notices(), [])
+        self.assertIsNone(self.c.collect_notices(10))
+        query("do $$ begin raise notice 'Gandalf was here!'; end $$")
+        self.assertEqual(self.c.notices(),
+                         [('NOTICE', 'Gandalf was here!')])
+        # draining removes the notices from the buffer
+        self.assertEqual(self.c.notices(), [])
+        # notices can be drained in batches with a maximum number
+        for n in range(4):
+            query("do $$ begin raise notice 'notice %s'; end $$" % n)
+        self.assertEqual(self.c.notices(3), [
+            ('NOTICE', 'notice 0'), ('NOTICE', 'notice 1'),
+            ('NOTICE', 'notice 2')])
+        self.assertEqual(self.c.notices(), [('NOTICE', 'notice 3')])
+        self.assertIsNone(self.c.collect_notices(0))
+        query("do $$ begin raise notice 'uncollected'; end $$")
+        self.assertEqual(self.c.notices(), [])
+
+    def testCollectNoticesOverflow(self):
+        self.assertIsNone(self.c.collect_notices(3))
+        for n in range(5):
+            self.c.query(
+                "do $$ begin raise notice 'notice %s'; end $$" % n)
+        # the buffer only keeps the three most recent notices
+        self.assertEqual(self.c.notices(), [
+            ('NOTICE', 'notice 2'), ('NOTICE', 'notice 3'),
+            ('NOTICE', 'notice 4')])
+
+    def testCollectNoticesSeverity(self):
+        self.assertIsNone(self.c.collect_notices(10, 'WARNING'))
+        self.c.query("do $$ begin"
+                     " raise notice 'too low';"
+                     " raise warning 'collected';"
+                     " end $$")
+        self.assertEqual(self.c.notices(), [('WARNING', 'collected')])
+
+    def testCaptureQueries(self):
+        query = self.c.query
+        self.assertRaises(ValueError, self.c.capture_queries, True, -1)
+        self.assertRaises(
+            TypeError, self.c.capture_queries, True, 0, 'invalid')
+        q = query('select 1')
+        self.assertIsNone(q.elapsed)
+        self.assertIsNone(q.rows_affected)
+        self.assertIsNone(self.c.capture_queries(True))
+        q = query('select 1 union select 2')
+        self.assertIsInstance(q.elapsed, float)
+        self.assertGreater(q.elapsed, 0)
+        self.assertEqual(q.rows_affected, 2)
+        self.assertIsNone(self.c.capture_queries(False))
+        q = query('select 1')
+        self.assertIsNone(q.elapsed)
+        self.assertIsNone(q.rows_affected)
+
+    def testCaptureQueriesExplainHook(self):
+        plans = []
+
+        def hook(sql, elapsed, plan):
+            plans.append((sql, elapsed, plan))
+
+        self.c.capture_queries(True, 0, hook)
+        self.addCleanup(self.c.capture_queries, False)
+        self.c.query('select 123')
+        self.assertEqual(len(plans), 1)
+        sql, elapsed, plan = plans[0]
+        self.assertEqual(sql, 'select 123')
+        self.assertIsInstance(elapsed, float)
+        self.assertIn('"Plan"', plan)
+        # parameterized statements cannot be explained after the fact
+        self.c.query('select $1::int', (123,))
+        self.assertEqual(len(plans), 1)
+        # fast statements are not explained with a high threshold
+        self.c.capture_queries(True, 60, hook)
+        self.c.query('select 456')
+        self.assertEqual(len(plans), 1)
+
+
+class TestConnectionPool(unittest.TestCase):
+    """Test the native connection pool."""
+
+    @staticmethod
+    def pool(size, maxsize=None, reset=True):
+        if maxsize is None:
+            maxsize = size
+        return pg.pool(size, maxsize, reset,
+                       dbname=dbname, host=dbhost, port=dbport)
+
+    def testPoolPrewarmsConnections(self):
+        p = self.pool(2)
+        try:
+            self.assertEqual(len(p), 2)
+            c = p.acquire()
+            self.assertEqual(len(p), 1)
+            self.assertEqual(c.query("select 1").getresult(), [(1,)])
+            p.release(c)
+            self.assertEqual(len(p), 2)
+        finally:
+            p.close()
+        self.assertEqual(len(p), 0)
+
+    def testPoolCreatesConnectionsOnDemand(self):
+        p = self.pool(0, 1)
+        try:
+            self.assertEqual(len(p), 0)
+            c1 = p.acquire()
+            c2 = p.acquire()
+            self.assertEqual(c1.query("select 1").getresult(), [(1,)])
+            self.assertEqual(c2.query("select 2").getresult(), [(2,)])
+            p.release(c1)
+            self.assertEqual(len(p), 1)
+            # the pool is full, additional connections are closed
+            p.release(c2)
+            self.assertEqual(len(p), 1)
+            self.assertRaises(TypeError, c2.query, "select 2")
+        finally:
+            p.close()
+
+    def testPoolResetsSessionState(self):
+        p = self.pool(1)
+        try:
+            c = p.acquire()
+            c.query("create temporary table test_pool (n smallint)")
+            p.release(c)
+            c = p.acquire()
+            self.assertRaises(pg.ProgrammingError,
+                              c.query, "select * from test_pool")
+            p.release(c)
+        finally:
+            p.close()
+
+    def testPoolWithoutReset(self):
+        p = self.pool(1, reset=False)
+        try:
+            c = p.acquire()
+            c.query("create temporary table test_pool (n smallint)")
+            p.release(c)
+            c = p.acquire()
+            r = c.query("select * from test_pool").getresult()
+            self.assertEqual(r, [])
+            p.release(c)
+        finally:
+            p.close()
+
+    def testPoolRejectsOtherObjects(self):
+        p = self.pool(0)
+        try:
+            self.assertRaises(TypeError, p.release, None)
+            self.assertRaises(TypeError, p.release, 42)
+        finally:
+            p.close()
+
+
+class TestMultiConnection(unittest.TestCase):
+    """Test the multi-connection object for scattered queries."""
+
+    def setUp(self):
+        self.conns = [connect() for _ in range(3)]
+        self.multi = pg.multiconnection(self.conns)
+
+    def tearDown(self):
+        for c in self.conns:
+            c.close()
+
+    def testMultiConnectionRejectsOtherObjects(self):
+        self.assertRaises(ValueError, pg.multiconnection)
+        self.assertRaises(TypeError, pg.multiconnection, None)
+        self.assertRaises(TypeError, pg.multiconnection, self.conns[0], 42)
+
+    def testMultiConnectionAsSequence(self):
+        self.assertEqual(len(self.multi), 3)
+        for i, c in enumerate(self.conns):
+            self.assertIs(self.multi[i], c)
+        self.assertRaises(IndexError, lambda: self.multi[3])
+
+    def testMultiConnectionQuery(self):
+        queries = self.multi.query("select 2 + 2")
+        self.assertIsInstance(queries, list)
+        self.assertEqual(len(queries), 3)
+        for q in queries:
+            self.assertEqual(q.getresult(), [(4,)])
+
+    def testMultiConnectionQueryWithParams(self):
+        queries = self.multi.query("select $1 + $2", (20, 22))
+        self.assertEqual([q.getresult()[0][0] for q in queries], [42] * 3)
+
+    def testMultiConnectionQueryRunsInParallel(self):
+        t0 = time.time()
+        queries = self.multi.query("select pg_sleep(0.2), 42")
+        t1 = time.time()
+        # all servers sleep at the same time, not one after the other
+        self.assertLess(t1 - t0, 0.5)
+        for q in queries:
+            self.assertEqual(q.getresult()[0][1], 42)
+
+    def testMultiConnectionSendQuery(self):
+        queries = self.multi.send_query("select 123")
+        self.assertEqual(len(queries), 3)
+        for q in queries:
+            self.assertEqual(q.getresult(), [(123,)])
+
 
 class TestConfigFunctions(unittest.TestCase):
     """Test the functions for changing default settings.
@@ -2481,6 +3113,33 @@ class TestConfigFunctions(unittest.TestCase):
         self.assertIsInstance(r, int)
         self.assertEqual(r, int(3425))
 
+    def testSetDecimalScale(self):
+        query = self.c.query
+        try:
+            query("select 1.23::numeric(10,2)")
+        except pg.DatabaseError:
+            self.skipTest('database does not support numeric')
+        pg.set_decimal_scale(2)
+        try:
+            r = query(
+                "select 1.23::numeric(10,2), -45.6::numeric(10,1),"
+                " 7::numeric, 0.001::numeric(10,3)").getresult()[0]
+        finally:
+            pg.set_decimal_scale(None)
+        # values fitting the scale come back as scaled integers
+        self.assertEqual(r[0], 123)
+        self.assertIsInstance(r[0], int)
+        self.assertEqual(r[1], -4560)
+        self.assertIsInstance(r[1], int)
+        self.assertEqual(r[2], 700)
+        self.assertIsInstance(r[2], int)
+        # values with a higher scale still come back as decimal values
+        self.assertEqual(r[3], pg.Decimal('0.001'))
+        self.assertIsInstance(r[3], pg.Decimal)
+        r = query("select 1.23::numeric(10,2)").getresult()[0][0]
+        self.assertIsInstance(r, pg.Decimal)
+        self.assertEqual(r, pg.Decimal('1.23'))
+
     def testGetBool(self):
         use_bool = pg.get_bool()
         # error if a parameter is passed
@@ -2607,6 +3266,92 @@ class TestConfigFunctions(unittest.TestCase):
         self.assertIsInstance(r, bytes)
         self.assertEqual(r, b'data')
 
+    def testSetZerocopy(self):
+        zerocopy = pg.get_zerocopy()
+        # error if no parameter is passed
+        self.assertRaises(TypeError, pg.set_zerocopy)
+        query = self.c.query
+        r = query("select 'plain'::text, 'data'::bytea").getresult()[0]
+        self.assertIsInstance(r[0], str)
+        self.assertIsInstance(r[1], bytes)
+        pg.set_zerocopy(True)
+        try:
+            q = query("select 'plain'::text, 'data'::bytea")
+            text_view, bytea_view = q.getresult()[0]
+        finally:
+            pg.set_zerocopy(zerocopy)
+        self.assertNotIsInstance(text_view, str)
+        self.assertNotIsInstance(bytea_view, bytes)
+        self.assertEqual(len(text_view), 5)
+        self.assertEqual(text_view.tobytes(), b'plain')
+        self.assertEqual(memoryview(text_view).tobytes(), b'plain')
+        self.assertEqual(len(bytea_view), 4)
+        self.assertEqual(bytea_view.tobytes(), b'data')
+        self.assertEqual(memoryview(bytea_view).tobytes(), b'data')
+        # the views keep the result storage alive after the query is gone
+        del q
+        self.assertEqual(text_view.tobytes(), b'plain')
+        self.assertEqual(bytea_view.tobytes(), b'data')
+
+    def testSetInterning(self):
+        query = self.c.query
+        pg.set_interning(True)
+        try:
+            q = query(
+                "select case when n % 2 = 0 then 'even' else 'odd' end,"
+                " (n % 2)::numeric + 0.5, array[n % 2]"
+                " from generate_series(1, 10) as s(n)")
+            r = q.getresult()
+        finally:
+            pg.set_interning(False)
+        self.assertEqual(r[0][0], 'odd')
+        self.assertEqual(r[1][0], 'even')
+        self.assertEqual(r[0][1], pg.Decimal('1.5'))
+        # repeated values in a column are returned as shared references
+        self.assertIs(r[0][0], r[2][0])
+        self.assertIs(r[1][0], r[3][0])
+        self.assertIs(r[0][1], r[2][1])
+        # mutable values such as arrays are never shared
+        self.assertEqual(r[1][2], r[3][2])
+        self.assertIsNot(r[1][2], r[3][2])
+
+    def testSetBinaryParams(self):
+        from datetime import date, datetime, time
+        query = self.c.query
+        pg.set_binary_params(True)
+        try:
+            r = query("select $1 + $2", (17, 25)).getresult()[0][0]
+            self.assertEqual(r, 42)
+            r = query("select $1::float8 * 2", (1.25,)).getresult()[0][0]
+            self.assertEqual(r, 2.5)
+            r = query("select not $1", (True,)).getresult()[0][0]
+            self.assertIs(r, False)
+            # bytes are passed as raw binary bytea without escaping
+            r = query("select octet_length($1)",
+                      (b'plain\x00data',)).getresult()[0][0]
+            self.assertEqual(r, 10)
+            r = query("select to_char($1::date + 1, 'YYYY-MM-DD')",
+                      (date(2022, 2, 22),)).getresult()[0][0]
+            self.assertEqual(r, '2022-02-23')
+            r = query("select extract(hour from $1::timestamp)",
+                      (datetime(2022, 2, 22, 12, 30),)).getresult()[0][0]
+            self.assertEqual(r, 12)
+            r = query("select extract(minute from $1::time)",
+                      (time(12, 30),)).getresult()[0][0]
+            self.assertEqual(r, 30)
+            # values without a binary encoding are still passed as text
+            r = query("select lower($1::text)", ('TEXT',)).getresult()[0][0]
+            self.assertEqual(r, 'text')
+            # huge integers do not fit into int8 and fall back to text
+            r = query("select $1::numeric - 1", (1 << 99,)).getresult()[0][0]
+            self.assertEqual(r, (1 << 99) - 1)
+            # the same query can be cached with different signatures
+            for value, expected in ((1, 2), (1.5, 2.5), (2, 3)):
+                r = query("select $1 + 1", (value,)).getresult()[0][0]
+                self.assertEqual(r, expected)
+        finally:
+            pg.set_binary_params(False)
+
     def testSetRowFactorySize(self):
         try:
             from functools import lru_cache
@@ -2628,9 +3373,13 @@ class TestConfigFunctions(unittest.TestCase):
             if lru_cache:
                 info = pg._row_factory.cache_info()
                 self.assertEqual(info.maxsize, maxsize)
-                self.assertEqual(info.hits + info.misses, 6)
-                self.assertEqual(
-                    info.hits, 0 if maxsize is not None and maxsize < 2 else 4)
+                if str is bytes:  # Python 2 still uses the Python factory
+                    self.assertEqual(info.hits + info.misses, 6)
+                    self.assertEqual(
+                        info.hits,
+                        0 if maxsize is not None and maxsize < 2 else 4)
+                else:  # named rows are built natively in C on Python 3
+                    self.assertEqual(info.hits + info.misses, 0)
 
 
 class TestStandaloneEscapeFunctions(unittest.TestCase):
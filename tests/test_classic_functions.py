@@ -343,6 +343,18 @@ class TestParseArray(unittest.TestCase):
             else:
                 self.assertEqual(f(string), expected)
 
+    def testParserWithLargeArray(self):
+        # exercises the single-pass fast path for flat arrays
+        f = pg.cast_array
+        expected = [float(n) / 2 for n in range(10000)]
+        string = '{' + ','.join(str(v) for v in expected) + '}'
+        self.assertEqual(f(string, float), expected)
+        expected = ['line {0},\\"{0}\\"'.format(n) for n in range(1000)]
+        string = '{' + ','.join(
+            '"%s"' % v.replace('\\', '\\\\').replace('"', '\\"')
+            for v in expected) + '}'
+        self.assertEqual(f(string), expected)
+
     def testParserWithDifferentDelimiter(self):
         f = pg.cast_array
 
@@ -984,6 +996,24 @@ class TestConfigFunctions(unittest.TestCase):
         r = pg.get_decimal()
         self.assertIs(r, decimal_class)
 
+    def testGetDecimalScale(self):
+        r = pg.get_decimal_scale()
+        self.assertIsNone(r)  # the default setting
+
+    def testSetDecimalScale(self):
+        try:
+            pg.set_decimal_scale(2)
+            r = pg.get_decimal_scale()
+            self.assertIsInstance(r, int)
+            self.assertEqual(r, 2)
+        finally:
+            pg.set_decimal_scale(None)
+        r = pg.get_decimal_scale()
+        self.assertIsNone(r)
+        self.assertRaises(ValueError, pg.set_decimal_scale, -1)
+        self.assertRaises(ValueError, pg.set_decimal_scale, 19)
+        self.assertRaises(TypeError, pg.set_decimal_scale, '2')
+
     def testGetBool(self):
         r = pg.get_bool()
         self.assertIsInstance(r, bool)
@@ -1030,6 +1060,111 @@ class TestConfigFunctions(unittest.TestCase):
         self.assertIsInstance(r, bool)
         self.assertIs(r, bytea_escaped)
 
+    def testGetZerocopy(self):
+        r = pg.get_zerocopy()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, False)
+
+    def testSetZerocopy(self):
+        zerocopy = pg.get_zerocopy()
+        try:
+            pg.set_zerocopy(True)
+            r = pg.get_zerocopy()
+            pg.set_zerocopy(zerocopy)
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, True)
+            pg.set_zerocopy(False)
+            r = pg.get_zerocopy()
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, False)
+        finally:
+            pg.set_zerocopy(zerocopy)
+        r = pg.get_zerocopy()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, zerocopy)
+
+    def testGetInterning(self):
+        r = pg.get_interning()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, False)
+
+    def testSetInterning(self):
+        interning = pg.get_interning()
+        try:
+            pg.set_interning(True)
+            r = pg.get_interning()
+            pg.set_interning(interning)
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, True)
+            pg.set_interning(False)
+            r = pg.get_interning()
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, False)
+        finally:
+            pg.set_interning(interning)
+        r = pg.get_interning()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, interning)
+
+    def testGetBinaryParams(self):
+        r = pg.get_binary_params()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, False)
+
+    def testSetBinaryParams(self):
+        binary_params = pg.get_binary_params()
+        try:
+            pg.set_binary_params(True)
+            r = pg.get_binary_params()
+            pg.set_binary_params(binary_params)
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, True)
+            pg.set_binary_params(False)
+            r = pg.get_binary_params()
+            self.assertIsInstance(r, bool)
+            self.assertIs(r, False)
+        finally:
+            pg.set_binary_params(binary_params)
+        r = pg.get_binary_params()
+        self.assertIsInstance(r, bool)
+        self.assertIs(r, binary_params)
+
+    def testGetSharedCache(self):
+        get_cache = pg.get_shared_cache
+        self.assertRaises(TypeError, get_cache)
+        self.assertRaises(TypeError, get_cache, 42)
+        try:
+            cache = get_cache('test:5432/shared_cache_db@test')
+            self.assertIsInstance(cache, dict)
+            self.assertEqual(cache, {})
+            cache['test_key'] = 'test_value'
+            r = get_cache('test:5432/shared_cache_db@test')
+            self.assertIs(r, cache)
+            self.assertEqual(r.get('test_key'), 'test_value')
+            r = get_cache('test:5432/other_db@test')
+            self.assertIsNot(r, cache)
+            self.assertEqual(r, {})
+        finally:
+            pg.clear_shared_cache()
+
+    def testClearSharedCache(self):
+        clear_cache = pg.clear_shared_cache
+        self.assertRaises(TypeError, clear_cache, 42)
+        try:
+            cache1 = pg.get_shared_cache('test:5432/db1@test')
+            cache2 = pg.get_shared_cache('test:5432/db2@test')
+            cache1['key'] = cache2['key'] = 'value'
+            clear_cache('test:5432/db1@test')
+            # connections keep their reference, only the content is gone
+            self.assertIs(pg.get_shared_cache('test:5432/db1@test'), cache1)
+            self.assertEqual(cache1, {})
+            self.assertEqual(cache2.get('key'), 'value')
+            clear_cache('test:5432/unknown_db@test')  # silently ignored
+            clear_cache()
+            self.assertEqual(cache2, {})
+        finally:
+            clear_cache()
+
     def testGetJsondecode(self):
         r = pg.get_jsondecode()
         self.assertTrue(callable(r))
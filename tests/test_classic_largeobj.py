@@ -252,6 +252,60 @@ class TestLargeObjects(unittest.TestCase):
         self.assertEqual(r, data[:8])
         self.obj.close()
 
+    def testReadinto(self):
+        readinto = self.obj.readinto
+        buf = bytearray(80)
+        # testing with invalid parameters
+        self.assertRaises(TypeError, readinto)
+        self.assertRaises(TypeError, readinto, 'invalid')
+        self.assertRaises(TypeError, readinto, buf, 'invalid')
+        # reading when object is not yet open
+        self.assertRaises(IOError, readinto, buf)
+        data = b'some data to be read'
+        self.obj.open(pg.INV_WRITE)
+        self.obj.write(data)
+        self.obj.close()
+        self.obj.open(pg.INV_READ)
+        r = readinto(buf)
+        self.assertIsInstance(r, int)
+        self.assertEqual(r, len(data))
+        self.assertEqual(bytes(buf[:r]), data)
+        # at the end of the object, zero is returned
+        r = readinto(buf)
+        self.assertEqual(r, 0)
+        self.obj.close()
+        self.obj.open(pg.INV_READ)
+        buf = bytearray(8)
+        r = readinto(buf)
+        self.assertEqual(r, 8)
+        self.assertEqual(bytes(buf), data[:8])
+        self.obj.close()
+
+    def testChunks(self):
+        chunks = self.obj.chunks
+        # testing with invalid parameters
+        self.assertRaises(TypeError, chunks)
+        self.assertRaises(TypeError, chunks, 'invalid')
+        self.assertRaises(ValueError, chunks, 0)
+        self.assertRaises(ValueError, chunks, -1)
+        data = b'some data to be iterated over'
+        self.obj.open(pg.INV_WRITE)
+        self.obj.write(data)
+        self.obj.close()
+        # iterating when object is not yet open
+        self.assertRaises(IOError, iter, self.obj)
+        self.obj.open(pg.INV_READ)
+        r = list(self.obj)
+        self.assertEqual(r, [data])
+        self.obj.close()
+        self.obj.open(pg.INV_READ)
+        self.assertIs(chunks(8), self.obj)
+        r = list(self.obj)
+        self.assertTrue(all(isinstance(chunk, bytes) for chunk in r))
+        self.assertEqual([len(chunk) for chunk in r], [8, 8, 8, 5])
+        self.assertEqual(b''.join(r), data)
+        self.obj.close()
+
     def testWrite(self):
         write = self.obj.write
         # testing with invalid parameters
@@ -453,6 +507,64 @@ class TestLargeObjects(unittest.TestCase):
         self.assertIsInstance(r, bytes)
         self.assertEqual(r, data)
 
+    def testCopyto(self):
+        copyto = self.obj.copyto
+        # testing with invalid parameters
+        self.assertRaises(TypeError, copyto)
+        self.assertRaises(ValueError, copyto, 1, 0)
+        data = b'some data to be copied'
+        self.obj.open(pg.INV_WRITE)
+        self.obj.write(data)
+        self.obj.close()
+        # copying when object is not yet open
+        f = tempfile.TemporaryFile()
+        self.assertRaises(IOError, copyto, f)
+        self.obj.open(pg.INV_READ)
+        self.assertRaises(TypeError, copyto, None)
+        self.assertRaises(ValueError, copyto, -1)
+        # copying via the file descriptor
+        r = copyto(f)
+        self.assertIsInstance(r, int)
+        self.assertEqual(r, len(data))
+        f.seek(0)
+        self.assertEqual(f.read(), data)
+        f.close()
+        self.obj.close()
+        # copying in small chunks to a file-like object
+        self.obj.open(pg.INV_READ)
+        written = []
+
+        class Writer:
+            def write(self, chunk):
+                written.append(chunk)
+
+        r = copyto(Writer(), 8)
+        self.assertEqual(r, len(data))
+        self.assertEqual([len(chunk) for chunk in written], [8, 8, 6])
+        self.assertEqual(b''.join(written), data)
+        self.obj.close()
+        # copying the remainder after a seek
+        self.obj.open(pg.INV_READ)
+        self.obj.seek(5, pg.SEEK_SET)
+        f = tempfile.TemporaryFile()
+        r = copyto(f)
+        self.assertEqual(r, len(data) - 5)
+        f.seek(0)
+        self.assertEqual(f.read(), data[5:])
+        f.close()
+        self.obj.close()
+        # pending buffered data is flushed before writing to the
+        # descriptor, so the output stays in order
+        self.obj.open(pg.INV_READ)
+        f = tempfile.TemporaryFile(buffering=8192)
+        f.write(b'buffered:')
+        r = copyto(f)
+        self.assertEqual(r, len(data))
+        f.seek(0)
+        self.assertEqual(f.read(), b'buffered:' + data)
+        f.close()
+        self.obj.close()
+
     def testExportInExistent(self):
         export = self.obj.export
         f = tempfile.NamedTemporaryFile()